@@ -59,6 +59,7 @@ Arena::~Arena() noexcept {
     }
 }
 
+//the nodes are kept, the next ones are rewound as the allocations reach them
 void Arena::reset() noexcept {  
     m_current      = m_head;
     m_head->offset = 0U;
@@ -132,6 +133,9 @@ bool Arena::createNextNode(const unsigned objectSize) {
         return false;
     }
 
+    //reuses a node kept by reset
+    m_current         = next;
+    m_current->offset = 0U;
     return true;
 }
 
@@ -0,0 +1,464 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "error.hpp"
+#include "json.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "token.hpp"
+#include "writer.hpp"
+
+namespace CPPJSON {
+
+//specialized by CPPJSON_BIND, readMember reads the value of the member named key into object and
+//writeMembers writes the keys and the values of the members of object
+template<typename T>
+struct Binding {
+    static const bool BOUND = false;
+};
+
+//Reads values from the tokens of the fused lexer straight into C++ types for Parser::parseInto.
+//The grammar steps and the errors are the ones of parse, values of the wrong type fail with Error::TYPE.
+//invalid is the error of a token that isn't a value, it depends on the container the value is in.
+//write does the opposite for serialize, the same types are written to a Writer.
+class Binder {
+    //skipped values are still validated
+    struct SkipHandler {
+        void startObject()                        noexcept {}
+        void endObject  ()                        noexcept {}
+        void startArray ()                        noexcept {}
+        void endArray   ()                        noexcept {}
+        void key        (const char*, unsigned)   noexcept {}
+        void string     (const char*, unsigned)   noexcept {}
+        void int64      (std::int64_t)            noexcept {}
+        void uint64     (std::uint64_t)           noexcept {}
+        void float64    (double)                  noexcept {}
+        void boolean    (bool)                    noexcept {}
+        void null       ()                        noexcept {}
+    };
+
+    static bool isValue(const Token::Type type) noexcept {
+        switch(type) {
+        case Token::Type::LCURLY:
+        case Token::Type::LBRACKET:
+        case Token::Type::STRING:
+        case Token::Type::INT:
+        case Token::Type::FLOAT:
+        case Token::Type::SCIENTIFIC_INT:
+        case Token::Type::BOOL:
+        case Token::Type::NUL:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    //null leaves the value unchanged
+    static Error mismatch(LexerStream &tokens, const Error invalid) noexcept {
+        const Token::Type type = tokens.current().getType();
+        if(type == Token::Type::NUL) {
+            tokens.advance();
+            return Error::NONE;
+        }
+
+        return isValue(type) ? Error::TYPE : invalid;
+    }
+
+    template<typename T>
+    static bool toIntegral(const std::int64_t number, T &value) noexcept {
+        if(number < 0 ? !std::is_signed<T>::value || number < std::int64_t(std::numeric_limits<T>::min())
+                      : std::uint64_t(number) > std::uint64_t(std::numeric_limits<T>::max())) {
+            return false;
+        }
+
+        value = T(number);
+        return true;
+    }
+
+    template<typename T>
+    static bool toIntegral(const std::uint64_t number, T &value) noexcept {
+        if(number > std::uint64_t(std::numeric_limits<T>::max())) {
+            return false;
+        }
+
+        value = T(number);
+        return true;
+    }
+
+    static Error decodeNumber(JSON &json, LexerStream &tokens) noexcept {
+        return Parser::decodeNumber(json, tokens.value(tokens.current()), tokens.current());
+    }
+
+    //the grammar steps of Parser::parseValue only need the keys of the members
+    class KeyReader {
+        Parser &m_parser;
+
+    public:
+        //the key can be in the buffer of the parser, it is only compared before the value is read
+        const char *name   = nullptr;
+        unsigned    length = 0U;
+
+        explicit KeyReader(Parser &owner) noexcept :
+            m_parser(owner)
+        {}
+
+        void  element  ()                                            noexcept {}
+        Error decodeKey(const char *const value, const Token &token) noexcept {
+            return m_parser.decodeEventString(value, token, name, length);
+        }
+        void  key      ()                                            noexcept {}
+    };
+
+public:
+    static Error read(Parser&, LexerStream &tokens, bool &value, unsigned, const Error invalid) noexcept {
+        if(tokens.current().getType() != Token::Type::BOOL) {
+            return mismatch(tokens, invalid);
+        }
+
+        value = tokens.value(tokens.current())[0] == 't';
+        tokens.advance();
+        return Error::NONE;
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, Error>::type
+    read(Parser&, LexerStream &tokens, T &value, unsigned, const Error invalid) noexcept {
+        const Token::Type type = tokens.current().getType();
+        if(type != Token::Type::INT && type != Token::Type::SCIENTIFIC_INT) {
+            return mismatch(tokens, invalid);
+        }
+
+        JSON json;
+        const Error error = decodeNumber(json, tokens);
+        if(error != Error::NONE) {
+            return error;
+        }
+
+        //scientific notation can still be a fraction
+        if(json.getType() == JSON::Type::INT64 ? !toIntegral(json.unsafeAsInt64(), value)
+         : json.getType() == JSON::Type::UINT64 ? !toIntegral(json.unsafeAsUint64(), value)
+         : true) {
+            return Error::TYPE;
+        }
+
+        tokens.advance();
+        return Error::NONE;
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value, Error>::type
+    read(Parser&, LexerStream &tokens, T &value, unsigned, const Error invalid) noexcept {
+        const Token::Type type = tokens.current().getType();
+        if(type != Token::Type::INT && type != Token::Type::FLOAT && type != Token::Type::SCIENTIFIC_INT) {
+            return mismatch(tokens, invalid);
+        }
+
+        JSON json;
+        const Error error = decodeNumber(json, tokens);
+        if(error != Error::NONE) {
+            return error;
+        }
+
+        switch(json.getType()) {
+        case JSON::Type::INT64:
+            value = T(json.unsafeAsInt64());
+            break;
+        case JSON::Type::UINT64:
+            value = T(json.unsafeAsUint64());
+            break;
+        default:
+            value = T(json.unsafeAsFloat64());
+        }
+
+        tokens.advance();
+        return Error::NONE;
+    }
+
+    static Error read(Parser &parser, LexerStream &tokens, std::string &value, unsigned, const Error invalid) noexcept {
+        if(tokens.current().getType() != Token::Type::STRING) {
+            return mismatch(tokens, invalid);
+        }
+
+        const char *str;
+        unsigned    length;
+        const Error error = parser.decodeEventString(tokens.value(tokens.current()), tokens.current(), str, length);
+        if(error != Error::NONE) {
+            return error;
+        }
+
+        try {
+            value.assign(str, std::size_t(length));
+        } catch(...) {
+            return Error::MEMORY;
+        }
+
+        tokens.advance();
+        return Error::NONE;
+    }
+
+    template<typename T, typename TAllocator>
+    static Error read(Parser &parser, LexerStream &tokens, std::vector<T, TAllocator> &values, const unsigned depth, const Error invalid) noexcept {
+        if(tokens.current().getType() != Token::Type::LBRACKET) {
+            return mismatch(tokens, invalid);
+        }
+
+        unsigned length;
+        bool     empty;
+        Error    error = parser.openContainer(tokens, true, std::size_t(depth), length, empty);
+        values.clear();
+        if(error != Error::NONE || empty) {
+            return error;
+        }
+
+        KeyReader keys(parser);
+        for(bool closed = false; !closed;) {
+            error = Parser::nextElement(tokens, keys);
+            if(error != Error::NONE) {
+                return error;
+            }
+
+            //read in a temporary since std::vector<bool> has no bool& to read into
+            T value = T();
+            error = read(parser, tokens, value, depth + 1U, Error::ARRAY_VALUE);
+            if(error != Error::NONE) {
+                return error;
+            }
+
+            try {
+                values.push_back(std::move(value));
+            } catch(...) {
+                return Error::MEMORY;
+            }
+
+            error = Parser::afterValue(tokens, true, closed);
+            if(error != Error::NONE) {
+                return error;
+            }
+        }
+
+        return Error::NONE;
+    }
+
+    template<typename T>
+    static typename std::enable_if<Binding<T>::BOUND, Error>::type
+    read(Parser &parser, LexerStream &tokens, T &object, const unsigned depth, const Error invalid) noexcept {
+        if(tokens.current().getType() != Token::Type::LCURLY) {
+            return mismatch(tokens, invalid);
+        }
+
+        unsigned length;
+        bool     empty;
+        Error    error = parser.openContainer(tokens, false, std::size_t(depth), length, empty);
+        if(error != Error::NONE || empty) {
+            return error;
+        }
+
+        KeyReader keys(parser);
+        for(bool closed = false; !closed;) {
+            error = Parser::nextMember(tokens, keys);
+            if(error != Error::NONE) {
+                return error;
+            }
+
+            error = Binding<T>::readMember(parser, tokens, object, keys.name, keys.length, depth + 1U);
+            if(error != Error::NONE) {
+                return error;
+            }
+
+            error = Parser::afterValue(tokens, false, closed);
+            if(error != Error::NONE) {
+                return error;
+            }
+        }
+
+        return Error::NONE;
+    }
+
+    //for the members that aren't bound
+    static Error skip(Parser &parser, LexerStream &tokens, const unsigned depth, const Error invalid) noexcept {
+        if(!isValue(tokens.current().getType())) {
+            return invalid;
+        }
+
+        SkipHandler                         handler;
+        Parser::EventBuilder<SkipHandler> builder(parser, handler);
+        return parser.parseValue(tokens, builder, depth);
+    }
+
+    static void write(Writer &writer, const bool value) noexcept {
+        writer.boolean(value);
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value && std::is_signed<T>::value>::type
+    write(Writer &writer, const T value) noexcept {
+        writer.int64(std::int64_t(value));
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value && !std::is_signed<T>::value>::type
+    write(Writer &writer, const T value) noexcept {
+        writer.uint64(std::uint64_t(value));
+    }
+
+    static void write(Writer &writer, const float value) noexcept {
+        writer.float32(value);
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value && !std::is_same<T, float>::value>::type
+    write(Writer &writer, const T value) noexcept {
+        writer.float64(double(value));
+    }
+
+    static void write(Writer &writer, const std::string &value) noexcept {
+        writer.string(value.data(), value.size());
+    }
+
+    template<typename T, typename TAllocator>
+    static void write(Writer &writer, const std::vector<T, TAllocator> &values) noexcept {
+        writer.startArray();
+        //const_reference is a bool for std::vector<bool>
+        for(typename std::vector<T, TAllocator>::const_reference value : values) {
+            write(writer, value);
+        }
+        writer.endArray();
+    }
+
+    template<typename T>
+    static typename std::enable_if<Binding<T>::BOUND>::type
+    write(Writer &writer, const T &object) noexcept {
+        writer.startObject();
+        Binding<T>::writeMembers(writer, object);
+        writer.endObject();
+    }
+};
+
+//writes value as compact JSON after what the writer already holds, T is any type parseInto reads.
+//No JSON is built, the only allocations are the ones that grow the buffer of the writer.
+template<typename T>
+Error serialize(const T &value, Writer &writer) noexcept {
+    Binder::write(writer, value);
+    return writer.getError();
+}
+
+template<typename T>
+Error Parser::parseInto(const std::string &data, T &value) noexcept {
+    assert(data[0] != '\0');
+
+    return parseInto(data.c_str(), data.size(), value);
+}
+
+template<typename T>
+Error Parser::parseInto(const char *const data, T &value) noexcept {
+    assert(data != nullptr);
+    assert(data[0] != '\0');
+
+    return parseInto(data, std::strlen(data), value);
+}
+
+template<typename T>
+Error Parser::parseInto(const char *const data, const std::size_t length, T &value) noexcept {
+    assert(data != nullptr);
+    assert(length > 0);
+
+    LexerStream tokens(data, length);
+    const Error error = Binder::read(*this, tokens, value, 0U, Error::TOKEN);
+
+    //the rest of the input is still lexed so errors are reported like in the other modes
+    if(tokens.hasError() || !tokens.drain()) {
+        return Error::TOKEN;
+    }
+    if(tokens.isUnbalanced()) {
+        return Error::MEMORY;
+    }
+
+    return error;
+}
+
+}
+
+//the variadic macros below apply CPPJSON_BIND_MEMBER to each member name, up to 32 of them.
+//CPPJSON_BIND_EXPAND makes MSVC's preprocessor split __VA_ARGS__ like the others
+#define CPPJSON_BIND_EXPAND(x) x
+#define CPPJSON_BIND_CONCAT_(a, b) a##b
+#define CPPJSON_BIND_CONCAT(a, b) CPPJSON_BIND_CONCAT_(a, b)
+#define CPPJSON_BIND_COUNT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, \
+    _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, N, ...) N
+#define CPPJSON_BIND_COUNT(...) CPPJSON_BIND_EXPAND(CPPJSON_BIND_COUNT_(__VA_ARGS__, 32, 31, 30, 29, 28, 27, 26, 25, \
+    24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0))
+
+#define CPPJSON_BIND_EACH_1(M, a)       M(a)
+#define CPPJSON_BIND_EACH_2(M, a, ...)  M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_1(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_3(M, a, ...)  M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_2(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_4(M, a, ...)  M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_3(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_5(M, a, ...)  M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_4(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_6(M, a, ...)  M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_5(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_7(M, a, ...)  M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_6(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_8(M, a, ...)  M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_7(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_9(M, a, ...)  M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_8(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_10(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_9(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_11(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_10(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_12(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_11(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_13(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_12(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_14(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_13(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_15(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_14(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_16(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_15(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_17(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_16(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_18(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_17(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_19(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_18(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_20(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_19(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_21(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_20(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_22(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_21(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_23(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_22(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_24(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_23(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_25(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_24(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_26(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_25(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_27(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_26(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_28(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_27(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_29(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_28(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_30(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_29(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_31(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_30(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH_32(M, a, ...) M(a) CPPJSON_BIND_EXPAND(CPPJSON_BIND_EACH_31(M, __VA_ARGS__))
+#define CPPJSON_BIND_EACH(M, ...) \
+    CPPJSON_BIND_EXPAND(CPPJSON_BIND_CONCAT(CPPJSON_BIND_EACH_, CPPJSON_BIND_COUNT(__VA_ARGS__))(M, __VA_ARGS__))
+
+//the length of the key is compared first, both the length and the name are constants so the compiler turns the
+//checks into a jump on the length followed by fixed size compares
+#define CPPJSON_BIND_MEMBER(member)                                                                   \
+    if(length == sizeof(#member) - 1U && std::memcmp(key, #member, sizeof(#member) - 1U) == 0) {      \
+        return ::CPPJSON::Binder::read(parser, tokens, object.member, depth, ::CPPJSON::Error::OBJECT_VALUE); \
+    }
+
+//member names are identifiers so the key is written as a literal without escaping it
+#define CPPJSON_BIND_WRITE_MEMBER(member)                                                             \
+    writer.rawKey("\"" #member "\":", sizeof("\"" #member "\":") - 1U);                               \
+    ::CPPJSON::Binder::write(writer, object.member);
+
+//binds the public members of TYPE to the keys with the same names for Parser::parseInto and serialize,
+//must be used outside of any namespace: CPPJSON_BIND(Point, x, y)
+#define CPPJSON_BIND(TYPE, ...)                                                                          \
+    namespace CPPJSON {                                                                                  \
+    template<>                                                                                           \
+    struct Binding<TYPE> {                                                                               \
+        static const bool BOUND = true;                                                                  \
+                                                                                                         \
+        static Error readMember(Parser &parser, LexerStream &tokens, TYPE &object, const char *const key, \
+                                const unsigned length, const unsigned depth) noexcept {                  \
+            CPPJSON_BIND_EACH(CPPJSON_BIND_MEMBER, __VA_ARGS__)                                          \
+            return ::CPPJSON::Binder::skip(parser, tokens, depth, ::CPPJSON::Error::OBJECT_VALUE);       \
+        }                                                                                                \
+                                                                                                         \
+        static void writeMembers(Writer &writer, const TYPE &object) noexcept {                          \
+            CPPJSON_BIND_EACH(CPPJSON_BIND_WRITE_MEMBER, __VA_ARGS__)                                    \
+        }                                                                                                \
+    };                                                                                                   \
+    }
@@ -1,13 +1,15 @@
 #pragma once
 
+#include <cstddef>
+
 struct Counters {
-    unsigned string          = 0U,
-             number          = 0U,
-             array           = 0U,
-             object          = 0U,
-             keyword         = 0U,
-             comma           = 0U,
-             chars           = 0U,
-             array_elements  = 0U,
-             object_elements = 0U;
+    std::size_t string          = 0U,
+                number          = 0U,
+                array           = 0U,
+                object          = 0U,
+                keyword         = 0U,
+                comma           = 0U,
+                chars           = 0U,
+                array_elements  = 0U,
+                object_elements = 0U;
 };
\ No newline at end of file
@@ -1,3 +1,6 @@
 #pragma once
 
-#include "parser.hpp"
\ No newline at end of file
+#include "parser.hpp"
+#include "lazy.hpp"
+#include "bind.hpp"
+#include "writer.hpp"
\ No newline at end of file
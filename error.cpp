@@ -37,7 +37,11 @@ const char *getErrorString(Error error) noexcept {
     case Error::MEMORY:
         return "Failed to allocate memory.";
     case Error::TOO_LARGE:
-        return "File/string/number too large. Maximum supported is UINT_MAX.";
+        return "String/number too large. Maximum supported is UINT_MAX.";
+    case Error::DEPTH:
+        return "Maximum nesting depth exceeded.";
+    case Error::TYPE:
+        return "Value doesn't match the type it is read into.";
     }
 
     return nullptr;
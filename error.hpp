@@ -19,7 +19,9 @@ enum class Error {
     MISSING_COMMA_OR_RBRACKET,
     FILE,
     MEMORY,
-    TOO_LARGE
+    TOO_LARGE,
+    DEPTH,
+    TYPE
 };
 
 const char *getErrorString(Error error) noexcept;
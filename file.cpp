@@ -62,14 +62,14 @@ std::int64_t FileContents::ftell(std::FILE *const file) noexcept {
 #endif    
 }
 
-void FileContents::setData(unsigned char *const data, const unsigned length) noexcept {
+void FileContents::setData(unsigned char *const data, const std::size_t length) noexcept {
     assert(data != nullptr || length == 0);
 
     m_data.reset(data);
     m_length = length;
 }
 
-void FileContents::setData(char *const data, const unsigned length) noexcept {
+void FileContents::setData(char *const data, const std::size_t length) noexcept {
     assert(data != nullptr || length == 0);
 
     setData(reinterpret_cast<unsigned char*>(data), length);
@@ -98,7 +98,7 @@ FileContents::Error FileContents::getError() const noexcept {
     return m_data == nullptr ? m_error : Error::NONE;
 }
 
-unsigned FileContents::getLength() const noexcept {
+std::size_t FileContents::getLength() const noexcept {
     return m_data == nullptr ? 0U : m_length;
 }
 
@@ -163,7 +163,8 @@ FileContents FileContents::get(const char *const path) noexcept {
         return fileContents;
     }
 
-    if(length >= std::int64_t(std::numeric_limits<unsigned>::max())) {
+    //the extra byte of the buffer must fit in a size_t
+    if(std::uint64_t(length) >= std::uint64_t(std::numeric_limits<std::size_t>::max())) {
         fileContents.setError(FileContents::Error::TOO_LARGE);
         return fileContents;
     }
@@ -176,7 +177,7 @@ FileContents FileContents::get(const char *const path) noexcept {
     unsigned char *data;
     try {
         //the buffer has 1 extra byte allocated in case a null terminated string is required
-        data = FileContents::Allocator::s_allocate(unsigned(length) + 1U);
+        data = FileContents::Allocator::s_allocate(std::size_t(length) + 1U);
     } catch(...) {
         fileContents.setError(FileContents::Error::MEMORY);
         return fileContents;
@@ -194,7 +195,7 @@ FileContents FileContents::get(const char *const path) noexcept {
     }
     data[length] = '\0';
 
-    fileContents.setData(data, unsigned(length));
+    fileContents.setData(data, std::size_t(length));
     
     return fileContents;
 }
@@ -210,5 +211,35 @@ void FileContents::setError(const Error error) noexcept {
     m_error = error;
 }
 
+FileContents::Error FileStream::open(const std::string &path) noexcept {
+    assert(path[0] != '\0');
+
+    return open(path.c_str());
+}
+
+FileContents::Error FileStream::open(const char *const path) noexcept {
+    assert(path != nullptr);
+    assert(path[0] != '\0');
+
+    FILE *file;
+    const FileContents::Error error = FileContents::fopen(&file, path, "rb");
+    if(error != FileContents::Error::NONE) {
+        return error;
+    }
+
+    m_file.reset(file);
+    return FileContents::Error::NONE;
+}
+
+std::size_t FileStream::read(char *const data, const std::size_t length) noexcept {
+    assert(m_file != nullptr);
+    assert(data != nullptr);
+
+    return std::fread(data, sizeof(data[0]), length, m_file.get());
+}
+
+bool FileStream::hasError() const noexcept {
+    return m_file == nullptr || std::ferror(m_file.get()) != 0;
+}
 
 }
\ No newline at end of file
@@ -5,13 +5,19 @@
     #include <unistd.h>
 #endif
 
+#include <cstddef>
+#include <cstdio>
+#include <memory>
 #include <string>
 
 #include "allocator.hpp"
 
 namespace CPPJSON {
 
+class FileStream;
+
 class FileContents {
+    friend class FileStream;
 
 public:
     enum class Error {
@@ -34,8 +40,8 @@ private:
 
     Data m_data = {nullptr, Allocator::s_deallocate};
     union {
-        Error    m_error = Error::NONE;
-        unsigned m_length;
+        Error       m_error = Error::NONE;
+        std::size_t m_length;
     };
 
     static Error        fopen(FILE **file, const char *const path, const char *const mode) noexcept;
@@ -49,16 +55,16 @@ public:
     FileContents &operator=(const FileContents&)          = delete;
     FileContents &operator=(FileContents&&)      noexcept = default;
 
-    void setData    (unsigned char *data, unsigned length = 0U) noexcept;
-    void setData    (char *data,          unsigned length = 0U) noexcept;
-    void setData    (std::nullptr_t)                            noexcept;
-    void setError   (Error error)                               noexcept;
+    void setData    (unsigned char *data, std::size_t length = 0U) noexcept;
+    void setData    (char *data,          std::size_t length = 0U) noexcept;
+    void setData    (std::nullptr_t)                               noexcept;
+    void setError   (Error error)                                  noexcept;
     
     unsigned char       *releaseData()     noexcept;
     unsigned char       *getData  ()       noexcept;
     const unsigned char *getData  () const noexcept;
     Error                getError () const noexcept;
-    unsigned             getLength() const noexcept;
+    std::size_t          getLength() const noexcept;
 
     Error put(const std::string &path) const noexcept;
     Error put(const char *path)        const noexcept;
@@ -67,4 +73,23 @@ public:
     static FileContents get(const char* path)        noexcept;
 };
 
+//reads a file in chunks, for files that are too large to be read at once
+class FileStream {
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> m_file = {nullptr, std::fclose};
+
+public:
+    FileStream()                             noexcept = default;
+    FileStream(const FileStream&)                     = delete;
+    FileStream(FileStream&&)                 noexcept = default;
+    FileStream &operator=(const FileStream&)          = delete;
+    FileStream &operator=(FileStream&&)      noexcept = default;
+
+    FileContents::Error open(const std::string &path) noexcept;
+    FileContents::Error open(const char *path)        noexcept;
+
+    //reads up to length bytes into data, 0 at the end of the file or if the read failed
+    std::size_t read    (char *data, std::size_t length) noexcept;
+    bool        hasError()                         const noexcept;
+};
+
 }
\ No newline at end of file
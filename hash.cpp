@@ -0,0 +1,116 @@
+#include <cstring>
+
+#include "hash.hpp"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+#endif
+
+namespace CPPJSON {
+namespace Hash {
+
+static const std::uint64_t SECRET[] = {
+    0x2D358DCCAA6C78A5U,
+    0x8BB84B93962EACC9U,
+    0x4B33A62ED433D4A3U,
+    0x4D5A2DA51DE1AA47U
+};
+
+//the low and the high 64 bits of the 128 bits product of a and b
+static void multiply(std::uint64_t &a, std::uint64_t &b) noexcept {
+#if defined(__SIZEOF_INT128__)
+    //__extension__ keeps -Wpedantic quiet about the 128 bits integer
+    __extension__ typedef unsigned __int128 Uint128;
+    const Uint128 product = static_cast<Uint128>(a) * b;
+    a = std::uint64_t(product);
+    b = std::uint64_t(product >> 64U);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    a = _umul128(a, b, &b);
+#else
+    const std::uint64_t aHigh = a >> 32U, aLow = a & 0xFFFFFFFFU,
+                        bHigh = b >> 32U, bLow = b & 0xFFFFFFFFU,
+                        high  = aHigh * bHigh,
+                        mid1  = aHigh * bLow,
+                        mid2  = aLow  * bHigh,
+                        low   = aLow  * bLow,
+                        carry = ((low >> 32U) + (mid1 & 0xFFFFFFFFU) + (mid2 & 0xFFFFFFFFU)) >> 32U;
+    a = low + (mid1 << 32U) + (mid2 << 32U);
+    b = high + (mid1 >> 32U) + (mid2 >> 32U) + carry;
+#endif
+}
+
+static std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept {
+    multiply(a, b);
+    return a ^ b;
+}
+
+//the bytes are read in the native order, hashes are only compared inside one process
+static std::uint64_t read8(const char *const data) noexcept {
+    std::uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static std::uint64_t read4(const char *const data) noexcept {
+    std::uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+//1 to 3 bytes, the first, the middle and the last byte
+static std::uint64_t read3(const char *const data, const std::size_t length) noexcept {
+    return std::uint64_t(static_cast<unsigned char>(data[0]))              << 16U
+         | std::uint64_t(static_cast<unsigned char>(data[length >> 1U]))   << 8U
+         | std::uint64_t(static_cast<unsigned char>(data[length - 1U]));
+}
+
+std::uint64_t hash(const char *data, const std::size_t length) noexcept {
+    std::uint64_t seed = mix(SECRET[0], SECRET[1]);
+    std::uint64_t a, b;
+
+    if(length <= 16U) {
+        //4 to 16 bytes are read as two pairs of 4 bytes that overlap when there are less than 16
+        if(length >= 4U) {
+            const std::size_t offset = (length >> 3U) << 2U;
+            a = read4(data) << 32U | read4(data + offset);
+            b = read4(data + length - 4U) << 32U | read4(data + length - 4U - offset);
+        } else if(length > 0U) {
+            a = read3(data, length);
+            b = 0U;
+        } else {
+            a = 0U;
+            b = 0U;
+        }
+    } else {
+        std::size_t remaining = length;
+        if(remaining > 48U) {
+            std::uint64_t seed1 = seed,
+                          seed2 = seed;
+            do {
+                seed       = mix(read8(data)      ^ SECRET[1], read8(data + 8U)  ^ seed);
+                seed1      = mix(read8(data + 16U) ^ SECRET[2], read8(data + 24U) ^ seed1);
+                seed2      = mix(read8(data + 32U) ^ SECRET[3], read8(data + 40U) ^ seed2);
+                data      += 48U;
+                remaining -= 48U;
+            } while(remaining > 48U);
+            seed ^= seed1 ^ seed2;
+        }
+        while(remaining > 16U) {
+            seed       = mix(read8(data) ^ SECRET[1], read8(data + 8U) ^ seed);
+            data      += 16U;
+            remaining -= 16U;
+        }
+        //the last 16 bytes, they can overlap the bytes that were already mixed
+        a = read8(data + remaining - 16U);
+        b = read8(data + remaining - 8U);
+    }
+
+    a ^= SECRET[1];
+    b ^= seed;
+    multiply(a, b);
+
+    return mix(a ^ SECRET[0] ^ std::uint64_t(length), b ^ SECRET[1]);
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CPPJSON {
+namespace Hash {
+
+//hash of length bytes in the style of wyhash, it reads 8 bytes at a time and the length is part of the hash
+std::uint64_t hash(const char *data, std::size_t length) noexcept;
+
+}
+}
\ No newline at end of file
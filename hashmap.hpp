@@ -0,0 +1,404 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <utility>
+
+namespace CPPJSON {
+
+//Open addressing hash map used by Object, its memory comes from the allocator in two arrays.
+//The entries are kept in insertion order without gaps so iterating is a walk over contiguous memory.
+//The slots are a power of two array of (hash, entry index) probed linearly, the hash is compared before the key
+//and growing the slots reuses it so keys are only hashed once. Removing an entry moves the last one in its place.
+//While the capacity is at most LINEAR_LIMIT there are no slots, the keys are compared one after the other instead
+//of being hashed since that is faster for a few keys. Growing past LINEAR_LIMIT hashes the entries into slots.
+template<typename TKey, typename TValue, typename THasher, typename TEqual, typename TAllocator, unsigned LINEAR_LIMIT>
+class HashMap {
+public:
+    typedef std::pair<const TKey, TValue> value_type;
+    typedef value_type                   *iterator;
+    typedef const value_type             *const_iterator;
+
+private:
+    struct Slot {
+        std::uint32_t hash;
+        std::uint32_t index;
+    };
+
+    typedef typename std::allocator_traits<TAllocator>::template rebind_alloc<Slot> SlotAllocator;
+
+    static const std::uint32_t EMPTY = ~std::uint32_t(0U);
+    //first capacity when inserting without reserving
+    static const unsigned MINIMUM_CAPACITY = 8U;
+
+    value_type *m_entries  = nullptr;
+    Slot       *m_slots    = nullptr;
+    unsigned    m_size     = 0U,
+                m_capacity = 0U,
+                m_slotMask = 0U;
+    TAllocator  m_allocator;
+
+    template<typename TLookup>
+    static std::uint32_t hash(const TLookup &key) {
+        return std::uint32_t(THasher()(key));
+    }
+
+    //more slots than entries so probing always reaches an empty slot, the table is at most 2/3 full
+    static unsigned slotCount(const unsigned capacity) noexcept {
+        unsigned count = 2U;
+        while(count <= capacity + capacity / 2U) {
+            count *= 2U;
+        }
+
+        return count;
+    }
+
+    template<typename T, typename TArrayAllocator>
+    static T *allocate(TArrayAllocator &allocator, const unsigned count) {
+        //an arena allocator without an arena returns nullptr
+        T *const data = std::allocator_traits<TArrayAllocator>::allocate(allocator, std::size_t(count));
+        if(data == nullptr) {
+            throw std::bad_alloc();
+        }
+
+        return data;
+    }
+
+    //the index of key or m_size, only used without slots
+    template<typename TLookup>
+    unsigned scan(const TLookup &key) const {
+        unsigned i = 0U;
+        for(; i < m_size && !TEqual()(m_entries[i].first, key); i++);
+        return i;
+    }
+
+    //the slot of key or the empty slot that ends its probe sequence, there must be slots
+    template<typename TLookup>
+    unsigned probe(const TLookup &key, const std::uint32_t keyHash) const {
+        assert(m_slots != nullptr);
+
+        for(unsigned i = keyHash & m_slotMask;; i = (i + 1U) & m_slotMask) {
+            const Slot &slot = m_slots[i];
+            if(slot.index == EMPTY || (slot.hash == keyHash && TEqual()(m_entries[slot.index].first, key))) {
+                return i;
+            }
+        }
+    }
+
+    void insertSlot(const Slot slot) noexcept {
+        unsigned i = slot.hash & m_slotMask;
+        for(; m_slots[i].index != EMPTY; i = (i + 1U) & m_slotMask);
+        m_slots[i] = slot;
+    }
+
+    //keys are const in value_type but the entry is destroyed right after it is moved from
+    static void relocate(value_type &from, value_type *const to) noexcept {
+        new (to) value_type(std::move(const_cast<TKey&>(from.first)), std::move(from.second));
+        from.~value_type();
+    }
+
+    //the slots are only allocated when capacity is above LINEAR_LIMIT
+    void reallocate(const unsigned capacity) {
+        assert(capacity >= m_size && capacity > 0U);
+
+        SlotAllocator   slotAllocator(m_allocator);
+        const unsigned  count   = capacity > LINEAR_LIMIT ? slotCount(capacity) : 0U;
+        value_type     *entries = allocate<value_type>(m_allocator, capacity);
+        Slot           *slots   = nullptr;
+        if(count > 0U) {
+            try {
+                slots = allocate<Slot>(slotAllocator, count);
+            } catch(...) {
+                std::allocator_traits<TAllocator>::deallocate(m_allocator, entries, std::size_t(capacity));
+                throw;
+            }
+        }
+
+        for(unsigned i = 0U; i < count; i++) {
+            slots[i].index = EMPTY;
+        }
+        for(unsigned i = 0U; i < m_size; i++) {
+            relocate(m_entries[i], entries + i);
+        }
+
+        Slot *const    oldSlots     = m_slots;
+        const unsigned oldSlotCount = oldSlots == nullptr ? 0U : m_slotMask + 1U;
+        deallocateEntries();
+
+        m_entries  = entries;
+        m_capacity = capacity;
+        m_slots    = slots;
+        m_slotMask = count == 0U ? 0U : count - 1U;
+        if(oldSlots != nullptr) {
+            for(unsigned i = 0U; i < oldSlotCount; i++) {
+                if(oldSlots[i].index != EMPTY) {
+                    insertSlot(oldSlots[i]);
+                }
+            }
+            std::allocator_traits<SlotAllocator>::deallocate(slotAllocator, oldSlots, std::size_t(oldSlotCount));
+        } else if(slots != nullptr) {
+            //the entries were scanned until now so this is the first time they are hashed
+            for(unsigned i = 0U; i < m_size; i++) {
+                insertSlot({hash(m_entries[i].first), i});
+            }
+        }
+    }
+
+    //only frees the entries array, its entries must already be destroyed or moved
+    void deallocateEntries() noexcept {
+        if(m_entries != nullptr) {
+            std::allocator_traits<TAllocator>::deallocate(m_allocator, m_entries, std::size_t(m_capacity));
+        }
+    }
+
+    void destroy() noexcept {
+        for(unsigned i = 0U; i < m_size; i++) {
+            m_entries[i].~value_type();
+        }
+        deallocateEntries();
+        if(m_slots != nullptr) {
+            SlotAllocator slotAllocator(m_allocator);
+            std::allocator_traits<SlotAllocator>::deallocate(slotAllocator, m_slots, std::size_t(m_slotMask + 1U));
+        }
+
+        m_entries  = nullptr;
+        m_slots    = nullptr;
+        m_size     = 0U;
+        m_capacity = 0U;
+        m_slotMask = 0U;
+    }
+
+    //the map must be empty, the entries keep their indices so the slots of map are inserted as they are.
+    //the copy only has slots when map has more than LINEAR_LIMIT entries and then map has slots too
+    void copy(const HashMap &map) {
+        assert(m_size == 0U);
+
+        if(map.m_size == 0U) {
+            return;
+        }
+
+        reallocate(map.m_size);
+        try {
+            for(; m_size < map.m_size; m_size++) {
+                new (m_entries + m_size) value_type(map.m_entries[m_size]);
+            }
+        } catch(...) {
+            destroy();
+            throw;
+        }
+
+        if(m_slots == nullptr) {
+            return;
+        }
+        for(unsigned i = 0U; i <= map.m_slotMask; i++) {
+            if(map.m_slots[i].index != EMPTY) {
+                insertSlot(map.m_slots[i]);
+            }
+        }
+    }
+
+    template<typename TKeyArgument>
+    TValue &insert(TKeyArgument &&key) {
+        if(m_slots == nullptr) {
+            const unsigned index = scan(key);
+            if(index < m_size) {
+                return m_entries[index].second;
+            }
+        } else {
+            const Slot &slot = m_slots[probe(key, hash(key))];
+            if(slot.index != EMPTY) {
+                return m_entries[slot.index].second;
+            }
+        }
+
+        if(m_size == m_capacity) {
+            unsigned capacity = m_capacity < MINIMUM_CAPACITY / 2U ? MINIMUM_CAPACITY : m_capacity * 2U;
+            //fills the entries up to LINEAR_LIMIT before hashing them
+            if(m_capacity < LINEAR_LIMIT && capacity > LINEAR_LIMIT) {
+                capacity = LINEAR_LIMIT;
+            }
+            reallocate(capacity);
+        }
+
+        //the slot is only taken once the entry is constructed
+        new (m_entries + m_size) value_type(
+            std::piecewise_construct,
+            std::forward_as_tuple(std::forward<TKeyArgument>(key)),
+            std::forward_as_tuple()
+        );
+        if(m_slots != nullptr) {
+            insertSlot({hash(m_entries[m_size].first), m_size});
+        }
+
+        return m_entries[m_size++].second;
+    }
+
+public:
+    HashMap(const TAllocator &allocator) noexcept :
+        m_allocator(allocator)
+    {}
+
+    HashMap(const HashMap &map) :
+        m_allocator(map.m_allocator)
+    {
+        copy(map);
+    }
+
+    HashMap(HashMap &&map) noexcept :
+        m_entries (map.m_entries),
+        m_slots   (map.m_slots),
+        m_size    (map.m_size),
+        m_capacity(map.m_capacity),
+        m_slotMask(map.m_slotMask),
+        m_allocator(map.m_allocator)
+    {
+        map.m_entries  = nullptr;
+        map.m_slots    = nullptr;
+        map.m_size     = 0U;
+        map.m_capacity = 0U;
+        map.m_slotMask = 0U;
+    }
+
+    ~HashMap() noexcept {
+        destroy();
+    }
+
+    HashMap &operator=(const HashMap &map) {
+        if(this != &map) {
+            destroy();
+            m_allocator = map.m_allocator;
+            copy(map);
+        }
+
+        return *this;
+    }
+
+    HashMap &operator=(HashMap &&map) noexcept {
+        if(this != &map) {
+            destroy();
+            m_entries      = map.m_entries;
+            m_slots        = map.m_slots;
+            m_size         = map.m_size;
+            m_capacity     = map.m_capacity;
+            m_slotMask     = map.m_slotMask;
+            m_allocator    = map.m_allocator;
+            map.m_entries  = nullptr;
+            map.m_slots    = nullptr;
+            map.m_size     = 0U;
+            map.m_capacity = 0U;
+            map.m_slotMask = 0U;
+        }
+
+        return *this;
+    }
+
+    //allocates room for exactly capacity entries
+    void reserve(const std::size_t capacity) {
+        assert(capacity <= std::size_t(EMPTY / 2U));
+
+        if(capacity > std::size_t(m_capacity)) {
+            reallocate(unsigned(capacity));
+        }
+    }
+
+    //TLookup can be any type that THasher and TEqual accept with a key, it hashes like an equal key
+    template<typename TLookup>
+    iterator find(const TLookup &key) {
+        return const_cast<iterator>(static_cast<const HashMap&>(*this).find(key));
+    }
+
+    template<typename TLookup>
+    const_iterator find(const TLookup &key) const {
+        if(m_slots == nullptr) {
+            return m_entries + scan(key);
+        }
+
+        const Slot &slot = m_slots[probe(key, hash(key))];
+        return slot.index == EMPTY
+            ? end()
+            : m_entries + slot.index;
+    }
+
+    TValue &operator[](const TKey &key) {
+        return insert(key);
+    }
+
+    TValue &operator[](TKey &&key) {
+        return insert(std::move(key));
+    }
+
+    template<typename TLookup>
+    std::size_t erase(const TLookup &key) {
+        if(m_slots == nullptr) {
+            const unsigned index = scan(key);
+            if(index == m_size) {
+                return 0U;
+            }
+
+            m_entries[index].~value_type();
+            if(index != m_size - 1U) {
+                relocate(m_entries[m_size - 1U], m_entries + index);
+            }
+            m_size--;
+
+            return 1U;
+        }
+
+        unsigned hole = probe(key, hash(key));
+        if(m_slots[hole].index == EMPTY) {
+            return 0U;
+        }
+        const std::uint32_t index = m_slots[hole].index;
+
+        //backward shift deletion: the slots after the hole move back unless the hole is before their home slot
+        for(unsigned next = (hole + 1U) & m_slotMask; m_slots[next].index != EMPTY; next = (next + 1U) & m_slotMask) {
+            const unsigned home = m_slots[next].hash & m_slotMask;
+            if(((next - home) & m_slotMask) >= ((next - hole) & m_slotMask)) {
+                m_slots[hole] = m_slots[next];
+                hole          = next;
+            }
+        }
+        m_slots[hole].index = EMPTY;
+
+        m_entries[index].~value_type();
+        const std::uint32_t last = m_size - 1U;
+        if(index != last) {
+            unsigned i = hash(m_entries[last].first) & m_slotMask;
+            for(; m_slots[i].index != last; i = (i + 1U) & m_slotMask);
+            m_slots[i].index = index;
+            relocate(m_entries[last], m_entries + index);
+        }
+        m_size--;
+
+        return 1U;
+    }
+
+    std::size_t size() const noexcept {
+        return std::size_t(m_size);
+    }
+
+    TAllocator get_allocator() const noexcept {
+        return m_allocator;
+    }
+
+    iterator begin() noexcept {
+        return m_entries;
+    }
+
+    const_iterator begin() const noexcept {
+        return m_entries;
+    }
+
+    iterator end() noexcept {
+        return m_entries + m_size;
+    }
+
+    const_iterator end() const noexcept {
+        return m_entries + m_size;
+    }
+};
+
+}
\ No newline at end of file
@@ -83,7 +83,9 @@ JSON::JSON(const JSON &json) {
 JSON::JSON(JSON &&json) noexcept : 
 m_type(json.m_type) {
     std::memcpy(static_cast<void*>(&m_value), &json.m_value, sizeof(m_value));
-    json.set();
+    //the containers now belong to this JSON, destroying them would empty the ones this JSON shares
+    json.m_type       = Type::NUL;
+    json.m_value.null = nullptr;
 }
 
 JSON::JSON(const double value) noexcept :
@@ -247,12 +249,15 @@ QueryBuilder<false> JSON::operator[](const String &key) noexcept {
 QueryBuilder<false> JSON::operator[](const char *const key) noexcept {
     assert(key != nullptr);
 
-    String stringKey(Object::getKeyAllocator());
-    stringKey = key;
-    const QueryBuilder<false> ret = (*this)[stringKey];
-    Object::getKeyAllocator().reset();
-    
-    return ret;
+    QueryBuilder<false> queryResult = QueryBuilder<false>(this); 
+    queryResult[key];
+    return queryResult;
+}
+
+QueryBuilder<false> JSON::operator[](const Object::Key &key) noexcept {
+    QueryBuilder<false> queryResult = QueryBuilder<false>(this); 
+    queryResult[key];
+    return queryResult;
 }
 
 QueryBuilder<true> JSON::operator[](const unsigned index) const noexcept { 
@@ -272,12 +277,17 @@ QueryBuilder<true> JSON::operator[](const String &key) const noexcept {
 }
 
 QueryBuilder<true> JSON::operator[](const char *const key) const noexcept {
-    String stringKey(Object::getKeyAllocator());
-    stringKey = key;
-    const QueryBuilder<true> ret = (*this)[stringKey];
-    Object::getKeyAllocator().reset();
+    assert(key != nullptr);
+
+    QueryBuilder<true> queryResult = QueryBuilder<true>(this); 
+    queryResult[key];
+    return queryResult;
+}
 
-    return ret;
+QueryBuilder<true> JSON::operator[](const Object::Key &key) const noexcept {
+    QueryBuilder<true> queryResult = QueryBuilder<true>(this); 
+    queryResult[key];
+    return queryResult;
 }
 
 Result<String&> JSON::asString() noexcept { 
@@ -465,7 +475,8 @@ void JSON::copy(const JSON &json) {
         break;
 
     case Type::OBJECT:
-        m_value = json.m_value.object;
+        //m_value doesn't hold an object yet, it can't be assigned to
+        new (&m_value.object) Object(json.m_value.object);
         break;
         
     default:
@@ -492,7 +503,14 @@ JSON &JSON::set(const char *const value, const String::Allocator &allocator) {
 }
 
 JSON &JSON::set(const String &value) {
-    return set(value.getCString(), value.getAllocator());
+    if(m_type != Type::STRING) {
+        destructor();
+        new (&m_value.string) String(value.getAllocator());
+        m_type = Type::STRING;
+    }
+    m_value.string = value;
+
+    return *this;
 }
 
 JSON &JSON::set(JSON &&value) {
@@ -500,7 +518,8 @@ JSON &JSON::set(JSON &&value) {
         destructor();
         m_type = value.m_type;
         std::memcpy(static_cast<void*>(&m_value), &value.m_value, sizeof(m_value));
-        value.set();
+        value.m_type       = Type::NUL;
+        value.m_value.null = nullptr;
     }
 
     return *this;
@@ -733,10 +752,9 @@ bool JSON::toFile(const char *const path, const unsigned indentation) const {
     assert(path[0] != '\0');
 
     std::string string = toString(indentation);
-    assert(string.size() < std::size_t(std::numeric_limits<unsigned>::max()));
 
     FileContents fileContents;
-    fileContents.setData(&string[0], unsigned(string.size()));
+    fileContents.setData(&string[0], string.size());
     const bool success = fileContents.put(path) == FileContents::Error::NONE;
     fileContents.releaseData();
 
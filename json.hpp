@@ -40,6 +40,9 @@ class QueryBuilder {
     template<typename T, Result<T>(JSON::*method)() const>
     Result<T> asValue() noexcept;
 
+    template<typename TKey>
+    QueryBuilder &member(const TKey &key) noexcept;
+
 public:
     QueryBuilder(JSONPtr json) noexcept;
 
@@ -47,6 +50,7 @@ public:
     QueryBuilder& operator[](const std::string&) noexcept;
     QueryBuilder& operator[](const String&)      noexcept;
     QueryBuilder& operator[](const char*)        noexcept;
+    QueryBuilder& operator[](const Object::Key&) noexcept;
     QueryBuilder& operator[](std::nullptr_t)     noexcept = delete;
 
     Result<JSONRef>        get      () noexcept;
@@ -140,12 +144,14 @@ public:
     QueryBuilder<false> operator[](const std::string&) noexcept;
     QueryBuilder<false> operator[](const String&)      noexcept;
     QueryBuilder<false> operator[](const char*)        noexcept;
+    QueryBuilder<false> operator[](const Object::Key&) noexcept;
     QueryBuilder<false> operator[](std::nullptr_t)     noexcept = delete;
 
     QueryBuilder<true> operator[](unsigned)           const noexcept;
     QueryBuilder<true> operator[](const std::string&) const noexcept;
     QueryBuilder<true> operator[](const String&)      const noexcept;
     QueryBuilder<true> operator[](const char*)        const noexcept;
+    QueryBuilder<true> operator[](const Object::Key&) const noexcept;
     QueryBuilder<true> operator[](std::nullptr_t)     const noexcept = delete;
 
     Result<String&> asString() noexcept;
@@ -275,8 +281,10 @@ QueryBuilder<IsConst> &QueryBuilder<IsConst>::operator[](const std::string &key)
     return (*this)[key.c_str()];
 }
 
+//String, const char* and Object::Key keys are all looked up without a copy
 template<bool IsConst>
-QueryBuilder<IsConst> &QueryBuilder<IsConst>::operator[](const String &key) noexcept {
+template<typename TKey>
+QueryBuilder<IsConst> &QueryBuilder<IsConst>::member(const TKey &key) noexcept {
     if(m_json == nullptr) {
         return *this;
     }
@@ -297,16 +305,21 @@ QueryBuilder<IsConst> &QueryBuilder<IsConst>::operator[](const String &key) noex
     return *this;
 }
 
+template<bool IsConst>
+QueryBuilder<IsConst> &QueryBuilder<IsConst>::operator[](const String &key) noexcept {
+    return member(key);
+}
+
 template <bool IsConst>
 QueryBuilder<IsConst> &QueryBuilder<IsConst>::operator[](const char *const key) noexcept {
     assert(key != nullptr);
 
-    String stringKey(Object::getKeyAllocator());
-    stringKey = key;
-    (*this)[stringKey];
-    Object::getKeyAllocator().reset();
+    return member(key);
+}
 
-    return *this;
+template<bool IsConst>
+QueryBuilder<IsConst> &QueryBuilder<IsConst>::operator[](const Object::Key &key) noexcept {
+    return member(key);
 }
 
 template<bool IsConst>
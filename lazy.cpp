@@ -0,0 +1,391 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "lazy.hpp"
+#include "lexer.hpp"
+#include "simd.hpp"
+#include "allocator.hpp"
+#include "counters.hpp"
+
+namespace CPPJSON {
+
+static bool isValue(const Token::Type type) noexcept {
+    switch(type) {
+    case Token::Type::LCURLY:
+    case Token::Type::LBRACKET:
+    case Token::Type::STRING:
+    case Token::Type::INT:
+    case Token::Type::FLOAT:
+    case Token::Type::SCIENTIFIC_INT:
+    case Token::Type::BOOL:
+    case Token::Type::NUL:
+        return true;
+    default:
+        return false;
+    }
+}
+
+//ignores the values of Parser::parse when only its error is needed
+struct IgnoreEvents {
+    void startObject()                        noexcept {}
+    void endObject  ()                        noexcept {}
+    void startArray ()                        noexcept {}
+    void endArray   ()                        noexcept {}
+    void key        (const char*, unsigned)   noexcept {}
+    void string     (const char*, unsigned)   noexcept {}
+    void int64      (std::int64_t)            noexcept {}
+    void uint64     (std::uint64_t)           noexcept {}
+    void float64    (double)                  noexcept {}
+    void boolean    (bool)                    noexcept {}
+    void null       ()                        noexcept {}
+};
+
+//the error Parser gives for input whose brackets don't match, Parser stops after the first value
+//so trailing unbalanced brackets are still reported with the error found by the brackets
+static Error parserError(const char *const data, const std::size_t length, const Error bracketError) noexcept {
+    IgnoreEvents events;
+    Parser       parser;
+    const Error  error = parser.parse(data, length, events);
+    return error != Error::NONE ? error : bracketError;
+}
+
+//the token after the value, containers store the distance to their closing token
+static const Token *skip(const Token *const token) noexcept {
+    const Token::Type type = token->getType();
+    if(type != Token::Type::LCURLY && type != Token::Type::LBRACKET) {
+        return token + 1;
+    }
+
+    if(token->getLength() < Token::MAX_LENGTH) {
+        return token + token->getLength() + 1;
+    }
+
+    //the distance saturated, match the brackets one token at a time
+    std::size_t depth = 0U;
+    for(const Token *current = token;; current++) {
+        switch(current->getType()) {
+        case Token::Type::LCURLY:
+        case Token::Type::LBRACKET:
+            depth++;
+            break;
+        case Token::Type::RCURLY:
+        case Token::Type::RBRACKET:
+            if(--depth == 0U) {
+                return current + 1;
+            }
+            break;
+        default:;
+        }
+    }
+}
+
+LazyValue::LazyValue(const LazyDocument *const document, const Token *const token) noexcept :
+    m_document(document),
+    m_token(token)
+{}
+
+const char *LazyValue::value() const noexcept {
+    assert(m_token != nullptr);
+
+    return m_document->m_tokens.value(*m_token);
+}
+
+bool LazyValue::decodeString(std::string &str, const char *const value, const Token &token) noexcept {
+    const std::size_t length = Parser::stringLength(value, token);
+
+    return length < std::size_t(std::numeric_limits<unsigned>::max()) && Parser::decodeStringToken(str, value, unsigned(length));
+}
+
+bool LazyValue::keyEquals(const char *const value, const Token &token, const char *const key, const std::size_t length) noexcept {
+    const std::size_t tokenLength = Parser::stringLength(value, token);
+    const char *const contents    = value + 1;
+    const std::size_t size        = tokenLength - 2U;
+
+    //without escape sequences the key is the token itself
+    if(Simd::findBackslashOrControlChar(contents, size) == size) {
+        return size == length && std::memcmp(contents, key, length) == 0;
+    }
+
+    std::string decoded;
+    return decodeString(decoded, value, token)
+        && decoded.size() == length
+        && std::memcmp(decoded.data(), key, length) == 0;
+}
+
+bool LazyValue::decodeNumber(JSON &json) const noexcept {
+    if(m_token == nullptr) {
+        return false;
+    }
+
+    switch(m_token->getType()) {
+    case Token::Type::INT:
+    case Token::Type::FLOAT:
+    case Token::Type::SCIENTIFIC_INT:
+        return Parser::decodeNumber(json, value(), *m_token) == Error::NONE;
+    default:
+        return false;
+    }
+}
+
+LazyValue LazyValue::operator[](const unsigned index) const noexcept {
+    if(m_token == nullptr || m_token->getType() != Token::Type::LBRACKET) {
+        return LazyValue();
+    }
+
+    const Token *current = m_token + 1;
+    for(unsigned i = 0U; i < index; i++) {
+        if(!isValue(current->getType())) {
+            return LazyValue();
+        }
+
+        current = skip(current);
+        if(current->getType() != Token::Type::COMMA) {
+            return LazyValue();
+        }
+        current++;
+    }
+
+    return isValue(current->getType()) ? LazyValue(m_document, current) : LazyValue();
+}
+
+LazyValue LazyValue::member(const char *const key, const std::size_t length) const noexcept {
+    if(m_token == nullptr || m_token->getType() != Token::Type::LCURLY) {
+        return LazyValue();
+    }
+
+    const Token *current = m_token + 1;
+    if(current->getType() == Token::Type::RCURLY) {
+        return LazyValue();
+    }
+
+    //the whole object is read since the last duplicate key wins, like in Parser
+    const Token *found = nullptr;
+    for(;;) {
+        if(current[0].getType() != Token::Type::STRING 
+        || current[1].getType() != Token::Type::COLON 
+        || !isValue(current[2].getType())
+        ){
+            return LazyValue();
+        }
+
+        if(keyEquals(m_document->m_tokens.value(*current), *current, key, length)) {
+            found = current + 2;
+        }
+
+        current = skip(current + 2);
+        if(current->getType() == Token::Type::RCURLY) {
+            break;
+        }
+        if(current->getType() != Token::Type::COMMA) {
+            return LazyValue();
+        }
+        current++;
+    }
+
+    return found == nullptr ? LazyValue() : LazyValue(m_document, found);
+}
+
+LazyValue LazyValue::operator[](const std::string &key) const noexcept {
+    return member(key.data(), key.size());
+}
+
+LazyValue LazyValue::operator[](const char *const key) const noexcept {
+    assert(key != nullptr);
+
+    return member(key, std::strlen(key));
+}
+
+bool LazyValue::isValid() const noexcept {
+    return m_token != nullptr;
+}
+
+Result<JSON::Type> LazyValue::getType() const noexcept {
+    if(m_token == nullptr) {
+        return Result<JSON::Type>::fromError(true);
+    }
+
+    switch(m_token->getType()) {
+    case Token::Type::LCURLY:
+        return Result<JSON::Type>::fromValue(JSON::Type::OBJECT);
+    case Token::Type::LBRACKET:
+        return Result<JSON::Type>::fromValue(JSON::Type::ARRAY);
+    case Token::Type::STRING:
+        return Result<JSON::Type>::fromValue(JSON::Type::STRING);
+    case Token::Type::BOOL:
+        return Result<JSON::Type>::fromValue(JSON::Type::BOOL);
+    case Token::Type::NUL:
+        return Result<JSON::Type>::fromValue(JSON::Type::NUL);
+    default: {
+        //the type of a number depends on its value
+        JSON json;
+        return decodeNumber(json)
+            ? Result<JSON::Type>::fromValue(json.getType())
+            : Result<JSON::Type>::fromError(true);
+    }
+    }
+}
+
+bool LazyValue::asString(std::string &str) const noexcept {
+    if(m_token == nullptr || m_token->getType() != Token::Type::STRING) {
+        return false;
+    }
+
+    str.clear();
+    return decodeString(str, value(), *m_token);
+}
+
+Result<double> LazyValue::asFloat64() const noexcept {
+    JSON json;
+    return decodeNumber(json) ? json.asFloat64() : Result<double>::fromError(true);
+}
+
+Result<std::int64_t> LazyValue::asInt64() const noexcept {
+    JSON json;
+    return decodeNumber(json) ? json.asInt64() : Result<std::int64_t>::fromError(true);
+}
+
+Result<std::uint64_t> LazyValue::asUint64() const noexcept {
+    JSON json;
+    return decodeNumber(json) ? json.asUint64() : Result<std::uint64_t>::fromError(true);
+}
+
+Result<std::nullptr_t> LazyValue::asNull() const noexcept {
+    return m_token == nullptr || m_token->getType() != Token::Type::NUL
+        ? Result<std::nullptr_t>::fromError(true)
+        : Result<std::nullptr_t>::fromValue(nullptr);
+}
+
+Result<bool> LazyValue::asBool() const noexcept {
+    return m_token == nullptr || m_token->getType() != Token::Type::BOOL
+        ? Result<bool>::fromError(true)
+        : Result<bool>::fromValue(value()[0] == 't');
+}
+
+ParserResult LazyValue::parse(Parser &parser) const noexcept {
+    if(m_token == nullptr) {
+        return ParserResult::fromError(Error::TOKEN);
+    }
+
+    const char *const start = value();
+    std::size_t       length;
+    switch(m_token->getType()) {
+    case Token::Type::LCURLY:
+    case Token::Type::LBRACKET: {
+        const Token &closingToken = *(skip(m_token) - 1);
+        length = std::size_t(m_document->m_tokens.value(closingToken) + 1 - start);
+        break;
+    }
+    case Token::Type::STRING:
+        length = Parser::stringLength(start, *m_token);
+        break;
+    default:
+        length = m_token->getLength();
+    }
+
+    return parser.parse(start, length);
+}
+
+Error LazyDocument::parse(const std::string &data) noexcept {
+    assert(data[0] != '\0');
+
+    return parse(data.c_str(), data.size());
+}
+
+Error LazyDocument::parse(const char *const data) noexcept {
+    assert(data != nullptr);
+    assert(data[0] != '\0');
+
+    return parse(data, std::strlen(data));
+}
+
+Error LazyDocument::parse(const char *const data, const std::size_t length) noexcept {
+    assert(data != nullptr);
+    assert(length > 0);
+
+    m_tokens.reset();
+    if(!m_tokens.reserve(length / 2U)) {
+        return Error::MEMORY;
+    }
+
+    Lexer lexer(data, length);
+    Counters counters;
+    const Lexer::Error lexerError = lexer.tokenize(m_tokens, counters);
+    if(lexerError != Lexer::Error::NONE) {
+        m_tokens.reset();
+        return lexerError == Lexer::Error::TOKEN ? Error::TOKEN : Error::MEMORY;
+    }
+
+    //containers store the distance to their closing token instead of their comma count,
+    //tokenize only rejected closing brackets outside of any container
+    Error error = Error::NONE;
+    try {
+        std::vector<std::size_t, GeneralAllocator<std::size_t>> containers{0, GeneralAllocator<std::size_t>()};
+
+        for(std::size_t i = 0U; i < m_tokens.data.size() && error == Error::NONE; i++) {
+            const Token::Type type = m_tokens.data[i].getType();
+            if(type == Token::Type::LCURLY || type == Token::Type::LBRACKET) {
+                containers.push_back(i);
+                continue;
+            }
+            if(type != Token::Type::RCURLY && type != Token::Type::RBRACKET) {
+                continue;
+            }
+
+            Token &container = m_tokens.data[containers.back()];
+            if(container.getType() == Token::Type::LBRACKET && type != Token::Type::RBRACKET) {
+                error = Error::MISSING_COMMA_OR_RBRACKET;
+            } else if(container.getType() == Token::Type::LCURLY && type != Token::Type::RCURLY) {
+                error = Error::MISSING_COMMA_OR_RCURLY;
+            }
+
+            container.setLength(i - containers.back());
+            containers.pop_back();
+        }
+
+        //the input ended inside a container
+        if(error == Error::NONE && !containers.empty()) {
+            error = m_tokens.data[containers.back()].getType() == Token::Type::LBRACKET ? Error::ARRAY : Error::OBJECT;
+        }
+    } catch(...) {
+        error = Error::MEMORY;
+    }
+
+    //the brackets only tell that the document is invalid, Parser walks the same grammar
+    //to find which error it reaches first
+    if(error != Error::NONE && error != Error::MEMORY) {
+        error = parserError(data, length, error);
+    }
+
+    if(error == Error::NONE && !isValue(m_tokens.data[0].getType())) {
+        error = Error::TOKEN;
+    }
+
+    if(error != Error::NONE) {
+        m_tokens.reset();
+    }
+
+    return error;
+}
+
+LazyValue LazyDocument::getRoot() const noexcept {
+    return m_tokens.data.empty() 
+        ? LazyValue()
+        : LazyValue(this, m_tokens.data.data());
+}
+
+LazyValue LazyDocument::operator[](const unsigned index) const noexcept {
+    return getRoot()[index];
+}
+
+LazyValue LazyDocument::operator[](const std::string &key) const noexcept {
+    return getRoot()[key];
+}
+
+LazyValue LazyDocument::operator[](const char *const key) const noexcept {
+    return getRoot()[key];
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "error.hpp"
+#include "json.hpp"
+#include "parser.hpp"
+#include "result.hpp"
+#include "token.hpp"
+#include "tokens.hpp"
+
+namespace CPPJSON {
+
+class LazyDocument;
+
+//A value of a LazyDocument, it is only decoded when one of the as* methods is called.
+//Missing keys, out of range indices and malformed containers give an invalid value whose as* methods fail.
+class LazyValue {
+    friend class LazyDocument;
+
+    const LazyDocument *m_document = nullptr;
+    const Token        *m_token    = nullptr;
+
+    LazyValue(const LazyDocument*, const Token*) noexcept;
+
+    const char *value       ()                                   const noexcept;
+    bool        decodeNumber(JSON&)                              const noexcept;
+    LazyValue   member      (const char *key, std::size_t length) const noexcept;
+
+    static bool decodeString(std::string&, const char *value, const Token&)                    noexcept;
+    static bool keyEquals   (const char *value, const Token&, const char *key, std::size_t length) noexcept;
+
+public:
+    LazyValue() noexcept = default;
+
+    LazyValue operator[](unsigned)           const noexcept;
+    LazyValue operator[](const std::string&) const noexcept;
+    LazyValue operator[](const char*)        const noexcept;
+    LazyValue operator[](std::nullptr_t)     const noexcept = delete;
+
+    bool                   isValid  ()             const noexcept;
+    Result<JSON::Type>     getType  ()             const noexcept;
+    bool                   asString (std::string&) const noexcept;
+    Result<double>         asFloat64()             const noexcept;
+    Result<std::int64_t>   asInt64  ()             const noexcept;
+    Result<std::uint64_t>  asUint64 ()             const noexcept;
+    Result<std::nullptr_t> asNull   ()             const noexcept;
+    Result<bool>           asBool   ()             const noexcept;
+
+    //builds the JSON of this value, only the tokens of the value are parsed again
+    ParserResult parse(Parser&) const noexcept;
+};
+
+//On-demand access to a document: parse only tokenizes the input, operator[] jumps over the containers it
+//doesn't visit and values are decoded when they are read.
+//The input isn't copied, it must outlive the document and its values.
+class LazyDocument {
+    friend class LazyValue;
+
+    Tokens m_tokens;
+
+public:
+    LazyDocument()                               noexcept = default;
+    LazyDocument(const LazyDocument&)                     = delete;
+    LazyDocument(LazyDocument&&)                 noexcept = default;
+    LazyDocument &operator=(const LazyDocument&)          = delete;
+    LazyDocument &operator=(LazyDocument&&)      noexcept = default;
+
+    Error parse(const std::string&)              noexcept;
+    Error parse(const char*)                     noexcept;
+    Error parse(const char*, std::size_t length) noexcept;
+
+    LazyValue getRoot   ()                   const noexcept;
+    LazyValue operator[](unsigned)           const noexcept;
+    LazyValue operator[](const std::string&) const noexcept;
+    LazyValue operator[](const char*)        const noexcept;
+    LazyValue operator[](std::nullptr_t)     const noexcept = delete;
+};
+
+}
\ No newline at end of file
@@ -2,7 +2,6 @@
 #include <cstring>
 #include <cctype>
 #include <algorithm>
-#include <stack>
 #include <vector>
 
 #include "lexer.hpp"
@@ -14,226 +13,256 @@
 
 namespace CPPJSON {
 
-bool Lexer::countCountainersElements(Tokens &tokens, Counters &counters) noexcept {
-    typedef GeneralAllocator<Token*>       Allocator;
-    typedef std::vector<Token*, Allocator> Vector;
-    typedef std::stack<Token*, Vector>     Stack;
+//indices of the open containers in the token vector, only spills to the heap past INLINE_DEPTH levels of nesting
+class ContainerStack {
+    typedef GeneralAllocator<std::size_t>       Allocator;
+    typedef std::vector<std::size_t, Allocator> Vector;
 
-    Vector vector(0, Allocator());
-    try {
-        vector.reserve(counters.object + counters.array);
-    } catch(...) {
-        return false;
-    }
-
-    Stack stack(std::move(vector));
+    static const std::size_t INLINE_DEPTH = 64U;
 
-    for(Token &token : tokens.data) {
-        switch(token.type) {
-        case Token::Type::LCURLY:
-        case Token::Type::LBRACKET: {
-            stack.push(&token);
-            continue;
-        }
+    std::size_t m_inline[INLINE_DEPTH];
+    std::size_t m_depth = 0U;
+    Vector      m_spilled{0, Allocator()};
 
-        case Token::Type::RCURLY:
-        case Token::Type::RBRACKET: {
-            if(stack.empty()) {
-                return false;
-            }
-
-            Token *const container = stack.top();
-            assert(container != nullptr);
-            assert(container->type == Token::Type::LCURLY || container->type == Token::Type::LBRACKET);
-            stack.pop();
-
-            if(container->type == Token::Type::LCURLY) {
-                counters.object_elements += std::max(container->length, Object::MINIMUM_CAPACITY);
-            } else {
-                counters.array_elements += std::max(container->length, Array::MINIMUM_CAPACITY);
-            }
+public:
+    bool empty() const noexcept {
+        return m_depth == 0U;
+    }
 
-            continue;
+    bool push(const std::size_t index) noexcept {
+        if(m_depth < INLINE_DEPTH) {
+            m_inline[m_depth++] = index;
+            return true;
         }
 
-        case Token::Type::COMMA: {
-            if(stack.empty()) {
-                return false;
-            }
-
-            Token *const container = stack.top();
-            assert(container != nullptr);
-            assert(container->type == Token::Type::LCURLY || container->type == Token::Type::LBRACKET);
-
-            container->length++;
-
-            continue;
+        try {
+            m_spilled.push_back(index);
+        } catch(...) {
+            return false;
         }
+        m_depth++;
+        return true;
+    }
 
-        default:
-            continue;
-        }
+    std::size_t top() const noexcept {
+        assert(m_depth > 0U);
+        return m_depth <= INLINE_DEPTH ? m_inline[m_depth - 1U] : m_spilled.back();
     }
 
-    return true;
-}
+    void pop() noexcept {
+        assert(m_depth > 0U);
+        if(m_depth > INLINE_DEPTH) {
+            m_spilled.pop_back();
+        }
+        m_depth--;
+    }
+};
 
-Lexer::Lexer(const char *const data, const unsigned length) noexcept :
+Lexer::Lexer(const char *const data, const std::size_t length) noexcept :
     m_data(data),
-    m_length(length)
+    m_length(length),
+    m_scanner(data, length)
 {}
 
-void Lexer::skipWhitespace() noexcept {
-    while(m_position < m_length && Util::isWhitespace(m_data[m_position])
-    ) {
-        m_position++;
+Lexer::Error Lexer::next(Token &token) noexcept {
+    //the structural scanner skips whitespace and string contents, each position is the start of a token
+    if(!m_scanner.next(m_position)) {
+        m_position   = m_length;
+        token.offset = std::uint32_t(m_length);
+        token.set(Token::Type::DONE, 0U);
+        return Error::NONE;
     }
+
+    token.offset = std::uint32_t(m_position);
+    switch(m_data[m_position]) {
+    case '{':
+        token.set(Token::Type::LCURLY, 1U);
+        break;
+    case '}':
+        token.set(Token::Type::RCURLY, 1U);
+        break;
+    case '[':
+        token.set(Token::Type::LBRACKET, 1U);
+        break;
+    case ']':
+        token.set(Token::Type::RBRACKET, 1U);
+        break;
+    case ':':
+        token.set(Token::Type::COLON, 1U);
+        break;
+    case ',':
+        token.set(Token::Type::COMMA, 1U);
+        break;
+    case '"':
+        if(!readString(token)) {
+            return Error::TOKEN;
+        }
+        assert(token.getLength() >= 2U);
+        break;
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+        if(!readNumber(token)) {
+            return Error::TOKEN;
+        }
+        assert(token.getLength() >= 1U);
+        break;
+    default:
+        if(!readKeyword(token)) {
+            readInvalidToken(token);
+            return Error::TOKEN;
+        }
+        assert(token.getLength() >= 4U);
+        break;
+    }
+
+    return Error::NONE;
 }
 
 Lexer::Error Lexer::tokenize(Tokens &tokens, Counters &counters) noexcept {
-    skipWhitespace();
+    //the commas of each container are counted in its opening token as the tokens are read
+    ContainerStack containers;
+    bool           unbalanced = false;
 
-    while(m_position < m_length) {
+    for(;;) {
         Token *const token = tokens.nextToken();
         if(token == nullptr) {
             return Error::MEMORY;
         }
 
-        token->value = m_data + m_position;
-        switch(*token->value) {
-        case '{':
-            token->length = 1U;
-            token->type   = Token::Type::LCURLY;
-            break;
-        case '}':
-            token->length = 1U;
-            token->type   = Token::Type::RCURLY;
-            counters.object++;
-            break;
-        case '[':
-            token->length = 1U;
-            token->type   = Token::Type::LBRACKET;
-            break;
-        case ']':
-            token->length = 1U;
-            token->type   = Token::Type::RBRACKET;
-            counters.array++;
+        if(next(*token) != Error::NONE) {
+            return Error::TOKEN;
+        }
+
+        //only inputs past 4 GB have tokens with a high offset
+        if((std::uint64_t(m_position) >> 32U) > std::uint64_t(tokens.segments.size()) && !tokens.addSegments(m_position)) {
+            return Error::MEMORY;
+        }
+
+        switch(token->getType()) {
+        case Token::Type::LCURLY:
+        case Token::Type::LBRACKET:
+            if(!containers.push(tokens.data.size() - 1U)) {
+                return Error::MEMORY;
+            }
             break;
-        case ':':
-            token->length = 1U;
-            token->type   = Token::Type::COLON;
+        case Token::Type::RCURLY:
+        case Token::Type::RBRACKET: {
+            if(token->getType() == Token::Type::RCURLY) {
+                counters.object++;
+            } else {
+                counters.array++;
+            }
+
+            if(containers.empty()) {
+                unbalanced = true;
+                break;
+            }
+
+            const Token &container = tokens.data[containers.top()];
+            assert(container.getType() == Token::Type::LCURLY || container.getType() == Token::Type::LBRACKET);
+            containers.pop();
+
+            if(container.getType() == Token::Type::LCURLY) {
+                counters.object_elements += std::max(container.getLength(), Object::MINIMUM_CAPACITY);
+            } else {
+                counters.array_elements += std::max(container.getLength(), Array::MINIMUM_CAPACITY);
+            }
             break;
-        case ',': {
-            token->length = 1U;
-            token->type   = Token::Type::COMMA;
+        }
+        case Token::Type::COMMA: {
             counters.comma++;
+
+            if(containers.empty()) {
+                unbalanced = true;
+                break;
+            }
+
+            Token &container = tokens.data[containers.top()];
+            assert(container.getType() == Token::Type::LCURLY || container.getType() == Token::Type::LBRACKET);
+            container.setLength(container.getLength() + 1U);
             break;
         }
-        case '"': {
-            if(!readString(*token)) {
-                return Error::TOKEN;
-            }
-            assert(token->length >= 2U);
+        case Token::Type::STRING:
             counters.string++;
-            counters.chars += token->length - 1U;
+            counters.chars += token->getLength() - 1U;
             break;
-        }
-        case '-':
-        case '0':
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9': {
-            if(!readNumber(*token)) {
-                 return Error::TOKEN;
-            }
-            assert(token->length >= 1U);
+        case Token::Type::INT:
+        case Token::Type::FLOAT:
+        case Token::Type::SCIENTIFIC_INT:
             counters.number++;
             break;
-        }
-        default: {
-            if(!readKeyword(*token)) {
-                readInvalidToken(*token);
-                return Error::TOKEN;
-            }
-            assert(token->length >= 4U);
+        case Token::Type::BOOL:
+        case Token::Type::NUL:
             counters.keyword++;
             break;
+        case Token::Type::DONE:
+            tokens.base         = m_data;
+            tokens.currentToken = tokens.data.data();
+            //a closing bracket or a comma outside of any container
+            return unbalanced ? Error::MEMORY : Error::NONE;
+        default:;
         }
-
-        }
-        
-        m_position += token->length;
-        skipWhitespace();
     }
-
-    Token *const token = tokens.nextToken();
-    if(token == nullptr) {
-        return Error::MEMORY;
-    }
-
-    token->type         = Token::Type::DONE;
-    token->length       = 0U;
-    tokens.currentToken = tokens.data.data();
-
-    return countCountainersElements(tokens, counters) ? Error::NONE : Error::MEMORY;
 }
 
 bool Lexer::readString(Token &token) noexcept {
-    const unsigned position = m_position + 1U;
-    bool escaping = false;
-    
-    unsigned i;
-    for(i = 0U; position + i < m_length; i++) {
-        const char c = m_data[position + i];
-        
-        if(c == '\\' && !escaping) {
-            escaping = true;
-        } else if(escaping) {
-            escaping = false;
-        } else if(c == '"') {
-            token.type   = Token::Type::STRING;
-            token.length = i + 2U;
+    std::size_t position = m_position + 1U;
+
+    //jumps from backslash to backslash, each one escapes the next character so runs of them pair up
+    while(position < m_length) {
+        position += Simd::findQuoteOrBackslash(m_data + position, m_length - position);
+        if(position >= m_length) {
+            break;
+        }
+
+        if(m_data[position] == '"') {
+            token.set(Token::Type::STRING, position - m_position + 1U);
             return true;
         }
+
+        position += 2U;
     }
     
-    token.type = Token::Type::INVALID;
-    token.length = i + 1U;
+    token.set(Token::Type::INVALID, m_length - m_position);
     return false;
 }
 
 bool Lexer::readNumber(Token &token) noexcept {
     const char *data   = m_data;
-    unsigned    length = m_length;
+    std::size_t length = m_length;
 
-    unsigned position, i;
+    std::size_t position, i, tokenLength;
+    Token::Type tokenType;
     bool success   = true;
     bool read_dot  = false;
     bool read_e    = false;
     bool read_sign = false;
 
     if(m_data[m_position] == '-') {
-        position     = m_position + 1U;
-        token.length = 1U;
+        position    = m_position + 1U;
+        tokenLength = 1U;
     } else {
-        position     = m_position;
-        token.length = 0U;
+        position    = m_position;
+        tokenLength = 0U;
     }
 
-    data       += position;
-    length     -= position;
-    token.type  = Token::Type::INT;
+    data      += position;
+    length    -= position;
+    tokenType  = Token::Type::INT;
 
     //0 as the first character is only allowed if it's followed by a dot or by a non-digit character
     if(data[0] == '0' && length > 1U && std::isdigit(data[1])) {
-        success    = false;
-        token.type = Token::Type::INVALID;
+        success   = false;
+        tokenType = Token::Type::INVALID;
 
         for(i = 0U; i < length; i++) {
             const char c = data[i];
@@ -251,12 +280,12 @@ bool Lexer::readNumber(Token &token) noexcept {
         
         switch(c) {
         case '.': {
-            token.type = Token::Type::FLOAT;
+            tokenType = Token::Type::FLOAT;
             if(!read_dot) {
                 read_dot = true;
             } else {
-                token.type = Token::Type::INVALID;
-                success    = false;
+                tokenType = Token::Type::INVALID;
+                success   = false;
             }
             break;
         }
@@ -264,11 +293,11 @@ bool Lexer::readNumber(Token &token) noexcept {
         case 'E': {
         case 'e':
             if(!read_e) {
-                read_e     = true;
-                token.type = Token::Type::SCIENTIFIC_INT;
+                read_e    = true;
+                tokenType = Token::Type::SCIENTIFIC_INT;
             } else {
-                token.type = Token::Type::INVALID;
-                success    = false;
+                tokenType = Token::Type::INVALID;
+                success   = false;
             }
             break;
         }
@@ -278,8 +307,8 @@ bool Lexer::readNumber(Token &token) noexcept {
             if(read_e && !read_sign) {
                 read_sign = true;
             } else {
-                token.type = Token::Type::INVALID;
-                success    = false;                
+                tokenType = Token::Type::INVALID;
+                success   = false;                
             }
             break;
         }
@@ -297,13 +326,13 @@ bool Lexer::readNumber(Token &token) noexcept {
             continue;
 
         default: {
-            token.type = Token::Type::INVALID;
-            success    = false;
+            tokenType = Token::Type::INVALID;
+            success   = false;
         }
         }
     }
 
-    token.length += i;
+    token.set(tokenType, tokenLength + i);
 
     return success;
 }
@@ -319,7 +348,7 @@ bool Lexer::readKeyword(Token &token) noexcept {
     };
 
     for(const auto &keyword : keywords) {
-        if(m_position + unsigned(keyword.value.size()) - 1U >= m_length) {
+        if(m_position + keyword.value.size() - 1U >= m_length) {
             continue;
         }
 
@@ -327,16 +356,14 @@ bool Lexer::readKeyword(Token &token) noexcept {
             continue;
         }
         
-        if(std::size_t(m_position) + keyword.value.size() >= m_length) {
-            token.type   = keyword.type;
-            token.length = unsigned(keyword.value.size());
+        if(m_position + keyword.value.size() >= m_length) {
+            token.set(keyword.type, unsigned(keyword.value.size()));
             return true;
         }
 
         const char nextChar = m_data[m_position + keyword.value.size()];
         if(Util::isWhitespace(nextChar) || Util::isDelimiter(nextChar)) {
-            token.type   = keyword.type;
-            token.length = unsigned(keyword.value.size());
+            token.set(keyword.type, unsigned(keyword.value.size()));
             return true;
         }
         
@@ -346,7 +373,7 @@ bool Lexer::readKeyword(Token &token) noexcept {
 }
 
 void Lexer::readInvalidToken(Token &token) noexcept {
-    unsigned i;
+    std::size_t i;
     for(i = m_position; i < m_length; i++) {
         const char c = m_data[i];
         if(Util::isWhitespace(c) || Util::isDelimiter(c)) {
@@ -355,8 +382,82 @@ void Lexer::readInvalidToken(Token &token) noexcept {
         };
     }
     
-    token.type   = Token::Type::INVALID;
-    token.length = i - m_position - 1U;
+    token.set(Token::Type::INVALID, i - m_position - 1U);
+}
+
+LexerStream::LexerStream(const char *const data, const std::size_t length) noexcept :
+    m_data(data),
+    m_lexer(data, length)
+{
+    fill(1U);
+}
+
+void LexerStream::fill(const unsigned count) noexcept {
+    assert(count <= LOOKAHEAD);
+
+    while(m_count < count && !m_done) {
+        const unsigned slot  = (m_head + m_count) % LOOKAHEAD;
+        Token         &token = m_tokens[slot];
+        m_count++;
+
+        //the token after an invalid one is always DONE since the lexer can't resume from it
+        if(m_error) {
+            token.offset        = std::uint32_t(0U);
+            m_highOffsets[slot] = 0U;
+            token.set(Token::Type::DONE, 0U);
+            m_done = true;
+            continue;
+        }
+
+        const Lexer::Error error = m_lexer.next(token);
+        m_highOffsets[slot] = std::uint32_t(std::uint64_t(m_lexer.getOffset()) >> 32U);
+        if(error != Lexer::Error::NONE) {
+            token.setType(Token::Type::INVALID);
+            m_error = true;
+            continue;
+        }
+
+        track(token);
+    }
+}
+
+//mirrors the bracket checks of Lexer::tokenize without needing a stack
+void LexerStream::track(const Token &token) noexcept {
+    switch(token.getType()) {
+    case Token::Type::LCURLY:
+    case Token::Type::LBRACKET:
+        m_depth++;
+        break;
+    case Token::Type::RCURLY:
+    case Token::Type::RBRACKET:
+        if(m_depth == 0U) {
+            m_unbalanced = true;
+        } else {
+            m_depth--;
+        }
+        break;
+    case Token::Type::COMMA:
+        if(m_depth == 0U) {
+            m_unbalanced = true;
+        }
+        break;
+    case Token::Type::DONE:
+        m_done = true;
+        break;
+    default:;
+    }
+}
+
+bool LexerStream::drain() noexcept {
+    Token token;
+    while(!m_done) {
+        if(m_error || m_lexer.next(token) != Lexer::Error::NONE) {
+            return false;
+        }
+        track(token);
+    }
+
+    return !m_error;
 }
 
 }
\ No newline at end of file
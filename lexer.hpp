@@ -1,25 +1,28 @@
 #pragma once
 
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include "token.hpp"
 #include "tokens.hpp"
 #include "allocator.hpp"
 #include "counters.hpp"
+#include "structural.hpp"
 
 namespace CPPJSON {
 
 class Lexer {   
-    const char    *m_data     = nullptr;
-    const unsigned m_length   = 0U;
-    unsigned       m_position = 0U;
+    const char        *m_data     = nullptr;
+    const std::size_t  m_length   = 0U;
+    std::size_t        m_position = 0U;
+    StructuralScanner  m_scanner;
 
-    void skipWhitespace          ()                               noexcept;
-    bool readString              (Token&)                         noexcept;
-    bool readNumber              (Token&)                         noexcept;
-    bool readKeyword             (Token&)                         noexcept;
-    void readInvalidToken        (Token&)                         noexcept;
-    bool countCountainersElements(Tokens &tokens, Counters &counters) noexcept;
+    bool readString      (Token&) noexcept;
+    bool readNumber      (Token&) noexcept;
+    bool readKeyword     (Token&) noexcept;
+    void readInvalidToken(Token&) noexcept;
 
 public:
     enum class Error {
@@ -28,10 +31,82 @@ public:
         MEMORY,
     };
     
-    Lexer(const char *data, unsigned length) noexcept;
-    Lexer()                                  noexcept = delete;
+    Lexer(const char *data, std::size_t length) noexcept;
+    Lexer()                                     noexcept = delete;
 
+    Error next    (Token &token)                      noexcept;
     Error tokenize(Tokens &tokens, Counters &counters) noexcept;
+
+    //the full offset of the last token, Token::offset only has its low 32 bits
+    std::size_t getOffset() const noexcept {
+        return m_position;
+    }
+};
+
+//Lexes tokens on demand for the fused parsing mode, keeps up to LOOKAHEAD tokens buffered past the current one.
+//A lexer error becomes an INVALID token followed by DONE.
+class LexerStream {
+public:
+    static const unsigned LOOKAHEAD = 4U;
+
+private:
+    const char   *m_data;
+    Lexer         m_lexer;
+    Token         m_tokens[LOOKAHEAD];
+    //the high 32 bits of the offset of each buffered token
+    std::uint32_t m_highOffsets[LOOKAHEAD];
+    unsigned      m_head       = 0U,
+                  m_count      = 0U,
+                  m_depth      = 0U;
+    bool          m_done       = false,
+                  m_error      = false,
+                  m_unbalanced = false;
+
+    void fill (unsigned count)     noexcept;
+    void track(const Token &token) noexcept;
+
+public:
+    LexerStream(const char *data, std::size_t length) noexcept;
+    LexerStream()                                     noexcept = delete;
+
+    Token &current() noexcept {
+        return m_tokens[m_head];
+    }
+
+    const char *value(const Token &token) const noexcept {
+        const std::uint64_t high = m_highOffsets[&token - m_tokens];
+        return m_data + std::size_t((high << 32U) | std::uint64_t(token.offset));
+    }
+
+    void advance() noexcept {
+        assert(m_count > 0U);
+
+        if(m_tokens[m_head].getType() == Token::Type::DONE) {
+            return;
+        }
+
+        m_head = (m_head + 1U) % LOOKAHEAD;
+        m_count--;
+        fill(1U);
+    }
+
+    //true if there are at least `count` tokens left before DONE, including the current one
+    bool hasTokens(const unsigned count) noexcept {
+        fill(count);
+        return m_count >= count && m_tokens[(m_head + count - 1U) % LOOKAHEAD].getType() != Token::Type::DONE;
+    }
+
+    bool hasError() const noexcept {
+        return m_error;
+    }
+
+    //a closing bracket or a comma outside of any container was lexed
+    bool isUnbalanced() const noexcept {
+        return m_unbalanced;
+    }
+
+    //lexes the rest of the input, false if any of it is invalid
+    bool drain() noexcept;
 };
 
 }
\ No newline at end of file
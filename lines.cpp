@@ -0,0 +1,318 @@
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <thread>
+
+#include "lines.hpp"
+#include "util.hpp"
+
+namespace CPPJSON {
+
+static const std::size_t CHUNK_SIZE = std::size_t(1U) << 20;
+
+//spins a little then sleeps so waiting threads don't take the cores of the workers
+static void backOff(const unsigned spins) noexcept {
+    if(spins < 64U) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+LinesWorkers::Slot::Slot() noexcept = default;
+
+LinesWorkers::LinesWorkers(const Parser::Options &options, const unsigned threads) noexcept :
+    m_options(options),
+    m_threads(threads)
+{
+    if(m_threads == 0U) {
+        m_threads = std::thread::hardware_concurrency();
+    }
+    if(m_threads == 0U) {
+        m_threads = 1U;
+    }
+}
+
+bool LinesWorkers::createSlots() noexcept {
+    //2 chunks per worker lets a worker parse ahead while the callback runs
+    m_slotCount = std::size_t(m_threads) * 2U;
+    m_slots.reset(new(std::nothrow) Slot[m_slotCount]);
+    if(m_slots == nullptr) {
+        return false;
+    }
+
+    for(std::size_t i = 0U; i < m_slotCount; i++) {
+        m_slots[i].state.store(2U * i, std::memory_order_relaxed);
+        m_slots[i].parser.setOptions(m_options);
+    }
+
+    return true;
+}
+
+bool LinesWorkers::waitForState(const Slot &slot, const std::size_t state) noexcept {
+    for(unsigned spins = 0U; slot.state.load(std::memory_order_acquire) != state; spins++) {
+        if(m_stop.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        backOff(spins);
+    }
+
+    return true;
+}
+
+//chunks start after the first newline at or after chunk * CHUNK_SIZE - 1, a chunk is empty if a record covers it
+std::size_t LinesWorkers::chunkStart(const std::size_t chunk) const noexcept {
+    if(chunk == 0U) {
+        return 0U;
+    }
+
+    const std::size_t position = chunk * CHUNK_SIZE - 1U;
+    if(position >= m_length) {
+        return m_length;
+    }
+
+    const char *const newline = static_cast<const char*>(std::memchr(m_data + position, '\n', m_length - position));
+    return newline == nullptr ? m_length : std::size_t(newline - m_data) + 1U;
+}
+
+//reads until the chunk ends with a newline or the file ends, the part after the last newline starts the next chunk
+void LinesWorkers::readChunk(Slot &slot) noexcept {
+    std::vector<char, GeneralAllocator<char>> &buffer = slot.buffer;
+
+    slot.offset = m_fileOffset;
+    std::size_t length = m_carryLength;
+    try {
+        if(buffer.size() < length + CHUNK_SIZE) {
+            buffer.resize(length + CHUNK_SIZE);
+        }
+        if(length != 0U) {
+            std::memcpy(buffer.data(), m_carry, length);
+        }
+
+        while(!m_endOfFile) {
+            if(buffer.size() - length < CHUNK_SIZE) {
+                buffer.resize(buffer.size() * 2U);
+            }
+
+            const std::size_t read = m_file->read(buffer.data() + length, CHUNK_SIZE);
+            if(read == 0U) {
+                if(m_file->hasError()) {
+                    slot.error       = Error::FILE;
+                    slot.errorOffset = m_fileOffset + length;
+                }
+                m_endOfFile = true;
+                break;
+            }
+
+            const std::size_t scanned = length;
+            length += read;
+
+            std::size_t end = length;
+            for(; end > scanned && buffer[end - 1U] != '\n'; end--);
+            if(end > scanned) {
+                m_carry       = buffer.data() + end;
+                m_carryLength = length - end;
+                slot.data     = buffer.data();
+                slot.length   = end;
+                m_fileOffset += end;
+                return;
+            }
+        }
+    } catch(...) {
+        slot.error       = Error::MEMORY;
+        slot.errorOffset = m_fileOffset;
+        m_endOfFile      = true;
+    }
+
+    //the rest of the file is the last chunk
+    m_carry       = nullptr;
+    m_carryLength = 0U;
+    slot.data     = buffer.data();
+    slot.length   = slot.error == Error::NONE ? length : 0U;
+    m_fileOffset += length;
+}
+
+bool LinesWorkers::claimChunk(Slot *&slot) noexcept {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const std::size_t chunk = m_nextChunk;
+    if(chunk >= m_chunkCount.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    slot = &m_slots[chunk % m_slotCount];
+    //the consumer frees the slot once the chunk slotCount chunks before this one is delivered
+    if(!waitForState(*slot, 2U * chunk)) {
+        return false;
+    }
+    m_nextChunk++;
+
+    slot->error = Error::NONE;
+    if(m_file == nullptr) {
+        const std::size_t start = chunkStart(chunk);
+        slot->data   = m_data + start;
+        slot->length = chunkStart(chunk + 1U) - start;
+        slot->offset = std::uint64_t(start);
+        return true;
+    }
+
+    readChunk(*slot);
+    if(slot->error != Error::NONE) {
+        m_chunkCount.store(chunk + 1U, std::memory_order_release);
+    } else if(slot->length == 0U) {
+        //nothing was left to read, the slot stays free
+        m_chunkCount.store(chunk, std::memory_order_release);
+        return false;
+    } else if(m_endOfFile && m_carryLength == 0U) {
+        m_chunkCount.store(chunk + 1U, std::memory_order_release);
+    }
+
+    return true;
+}
+
+//same as Parser::parseLines but the records are kept until the chunk is delivered
+void LinesWorkers::parseChunk(Slot &slot) noexcept {
+    const char *const end     = slot.data + slot.length;
+    const char       *current = slot.data;
+
+    while(current != end && slot.error == Error::NONE) {
+        const char *newline = static_cast<const char*>(std::memchr(current, '\n', std::size_t(end - current)));
+        if(newline == nullptr) {
+            newline = end;
+        }
+
+        const std::size_t length = std::size_t(newline - current);
+        std::size_t i = 0U;
+        for(; i < length && Util::isWhitespace(current[i]); i++);
+
+        if(i != length) {
+            const ParserResult parserResult = slot.parser.parse(current, length);
+            if(parserResult.isSuccess()) {
+                try {
+                    slot.records.push_back(&parserResult.getRef());
+                } catch(...) {
+                    slot.error = Error::MEMORY;
+                }
+            } else {
+                slot.error = parserResult.getError();
+            }
+
+            if(slot.error != Error::NONE) {
+                slot.errorOffset = slot.offset + std::uint64_t(current - slot.data);
+            }
+        }
+
+        current = newline == end ? end : newline + 1;
+    }
+}
+
+void LinesWorkers::work() noexcept {
+    Slot *slot = nullptr;
+    while(claimChunk(slot)) {
+        if(slot->error == Error::NONE) {
+            parseChunk(*slot);
+        }
+
+        const std::size_t state = slot->state.load(std::memory_order_relaxed);
+        slot->state.store(state + 1U, std::memory_order_release);
+    }
+}
+
+Parser::LinesResult LinesWorkers::run(const Parser::LineCallback &callback) noexcept {
+    Parser::LinesResult result;
+
+    std::vector<std::thread> workers;
+    try {
+        workers.reserve(m_threads);
+        for(unsigned i = 0U; i < m_threads; i++) {
+            workers.emplace_back(&LinesWorkers::work, this);
+        }
+    } catch(...) {}
+
+    //keeps going with the workers that could be started
+    if(workers.empty()) {
+        result.error = Error::MEMORY;
+        return result;
+    }
+
+    for(std::size_t chunk = 0U;; chunk++) {
+        Slot &slot = m_slots[chunk % m_slotCount];
+
+        bool ready = true;
+        for(unsigned spins = 0U; slot.state.load(std::memory_order_acquire) != 2U * chunk + 1U; spins++) {
+            if(chunk >= m_chunkCount.load(std::memory_order_acquire)) {
+                ready = false;
+                break;
+            }
+            backOff(spins);
+        }
+        if(!ready) {
+            break;
+        }
+
+        for(JSON *const json : slot.records) {
+            callback(*json);
+            result.records++;
+        }
+
+        if(slot.error != Error::NONE) {
+            result.error  = slot.error;
+            result.offset = slot.errorOffset;
+            break;
+        }
+
+        slot.records.clear();
+        slot.parser.reset();
+        slot.state.store(2U * (chunk + m_slotCount), std::memory_order_release);
+    }
+
+    m_stop.store(true, std::memory_order_relaxed);
+    for(std::thread &worker : workers) {
+        worker.join();
+    }
+
+    return result;
+}
+
+Parser::LinesResult LinesWorkers::parse(const char *const data, const std::size_t length, const Parser::LineCallback &callback) noexcept {
+    assert(data != nullptr || length == 0U);
+
+    Parser::LinesResult result;
+    if(!createSlots()) {
+        result.error = Error::MEMORY;
+        return result;
+    }
+
+    m_data   = data;
+    m_length = length;
+    m_chunkCount.store(length / CHUNK_SIZE + (length % CHUNK_SIZE != 0U ? 1U : 0U), std::memory_order_relaxed);
+
+    return run(callback);
+}
+
+Parser::LinesResult LinesWorkers::parseFile(const char *const path, const Parser::LineCallback &callback) noexcept {
+    assert(path != nullptr);
+    assert(path[0] != '\0');
+
+    Parser::LinesResult result;
+
+    FileStream file;
+    if(file.open(path) != FileContents::Error::NONE) {
+        result.error = Error::FILE;
+        return result;
+    }
+
+    if(!createSlots()) {
+        result.error = Error::MEMORY;
+        return result;
+    }
+
+    m_file = &file;
+    m_chunkCount.store(std::numeric_limits<std::size_t>::max(), std::memory_order_relaxed);
+
+    return run(callback);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "parser.hpp"
+#include "file.hpp"
+#include "allocator.hpp"
+
+namespace CPPJSON {
+
+//Parses newline delimited JSON on several threads for Parser::parseLines.
+//The input is cut in chunks that end on a newline, workers parse whole chunks into the parser of a slot and
+//the calling thread passes the records to the callback in input order before handing the slot to the chunk
+//that is slotCount chunks later. Only claiming a chunk takes a lock, records are parsed and delivered without one.
+//Experimental: the scaling hasn't been measured on several cores, on one core it is slower than the sequential path.
+class LinesWorkers {
+    struct Slot {
+        //2 * chunk when the slot is free for chunk, 2 * chunk + 1 once chunk is parsed
+        std::atomic<std::size_t> state{0U};
+        Parser                   parser;
+        std::vector<JSON*, GeneralAllocator<JSON*>> records{0, GeneralAllocator<JSON*>()};
+        //holds the chunk when reading a file, only grows
+        std::vector<char, GeneralAllocator<char>>   buffer {0, GeneralAllocator<char>()};
+        const char              *data        = nullptr;
+        std::size_t              length      = 0U;
+        std::uint64_t            offset      = 0U;
+        Error                    error       = Error::NONE;
+        std::uint64_t            errorOffset = 0U;
+
+        Slot() noexcept;
+    };
+
+    Parser::Options          m_options;
+    unsigned                 m_threads;
+    std::unique_ptr<Slot[]>  m_slots;
+    std::size_t              m_slotCount  = 0U;
+    std::atomic<bool>        m_stop{false};
+    //the number of chunks, only known once the end of a file is reached
+    std::atomic<std::size_t> m_chunkCount{0U};
+
+    //claiming a chunk and reading a file are serialized by m_mutex
+    std::mutex               m_mutex;
+    std::size_t              m_nextChunk  = 0U;
+    const char              *m_data       = nullptr;
+    std::size_t              m_length     = 0U;
+    FileStream              *m_file       = nullptr;
+    //the partial record at the end of the previous chunk of a file, it stays in the buffer of its slot
+    const char              *m_carry      = nullptr;
+    std::size_t              m_carryLength = 0U;
+    std::uint64_t            m_fileOffset  = 0U;
+    bool                     m_endOfFile   = false;
+
+    bool                createSlots()                              noexcept;
+    bool                waitForState(const Slot&, std::size_t)      noexcept;
+    bool                claimChunk  (Slot*&)                        noexcept;
+    std::size_t         chunkStart  (std::size_t chunk) const       noexcept;
+    void                readChunk   (Slot&)                         noexcept;
+    static void         parseChunk  (Slot&)                         noexcept;
+    void                work        ()                              noexcept;
+    Parser::LinesResult run         (const Parser::LineCallback&)   noexcept;
+
+public:
+    //0 threads uses every core
+    LinesWorkers(const Parser::Options&, unsigned threads) noexcept;
+    LinesWorkers(const LinesWorkers&)                      = delete;
+    LinesWorkers &operator=(const LinesWorkers&)           = delete;
+
+    Parser::LinesResult parse    (const char*, std::size_t length, const Parser::LineCallback&) noexcept;
+    Parser::LinesResult parseFile(const char *path, const Parser::LineCallback&)               noexcept;
+};
+
+}
\ No newline at end of file
@@ -1,14 +1,16 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 
 namespace CPPJSON {
 
 #ifndef NDEBUG
 
+//atomic since parseLines can parse on several threads
 struct AllocationStats {
-    unsigned allocated   = 0U;
-    unsigned deallocated = 0U;
+    std::atomic<unsigned> allocated  {0U};
+    std::atomic<unsigned> deallocated{0U};
 
     static const AllocationStats &get() noexcept;
 };
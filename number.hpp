@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace CPPJSON {
+namespace Number {
+
+//parse number tokens in place, without copying or depending on the locale.
+//success is false if the token isn't entirely a number of that type or if it's out of range.
+std::uint64_t parseUint64          (const char *str, unsigned length, bool &success) noexcept;
+std::int64_t  parseInt64           (const char *str, unsigned length, bool &success) noexcept;
+double        parseFloat64         (const char *str, unsigned length, bool &success) noexcept;
+
+//integers written with a fraction or an exponent (1e5, -2.5E3). integral is false if the number is well formed
+//but has a fractional part, it should then be parsed as a double
+std::uint64_t parseScientificUint64(const char *str, unsigned length, bool &integral, bool &success) noexcept;
+std::int64_t  parseScientificInt64 (const char *str, unsigned length, bool &integral, bool &success) noexcept;
+
+}
+}
\ No newline at end of file
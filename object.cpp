@@ -10,15 +10,12 @@ namespace CPPJSON {
 
 const unsigned Object::MINIMUM_CAPACITY = 8U;
 
-Arena Object::s_keyArena(Arena::MINIMUM_CAPACITY, Arena::INFINITE_NODES, "Object Keys Arena");
-Object::KeyAllocator Object::s_keyAllocator(&s_keyArena);
-
 Object::Object(const Allocator &allocator) :
-m_data(0, StringHasher(), StringEqual(), allocator)
+m_data(allocator)
 {}
 
 Object::Object(Allocator &&allocator) noexcept : 
-m_data(0, StringHasher(), StringEqual(), std::move(allocator))
+m_data(allocator)
 {}
 
 Object::~Object() noexcept {}
@@ -38,7 +35,7 @@ Object &Object::operator=(Object &&object) noexcept {
 }
 
 bool Object::reserve(unsigned capacity) noexcept {
-    if (capacity < Object::MINIMUM_CAPACITY) {
+    if (capacity == 0U) {
         capacity = Object::MINIMUM_CAPACITY;
     }
 
@@ -52,14 +49,16 @@ bool Object::reserve(unsigned capacity) noexcept {
 }
 
 Result<JSON&> Object::get(const String &key) noexcept {
-    return has(key)
-        ? Result<JSON&>::fromRef(m_data.at(key))
+    const iterator it = m_data.find(key);
+    return it != m_data.end()
+        ? Result<JSON&>::fromRef(it->second)
         : Result<JSON&>::fromError(true);
 }
 
 Result<const JSON&> Object::get(const String &key) const noexcept {
-    return has(key)
-        ? Result<const JSON&>::fromRef(m_data.at(key))
+    const const_iterator it = m_data.find(key);
+    return it != m_data.end()
+        ? Result<const JSON&>::fromRef(it->second)
         : Result<const JSON&>::fromError(true);
 }
 
@@ -74,10 +73,7 @@ void Object::remove(const String &key) noexcept {
 void Object::remove(const char *const key) noexcept {
     assert(key != nullptr);
 
-    String stringKey(s_keyAllocator);
-    stringKey = key;
-    remove(stringKey);
-    s_keyAllocator.reset();
+    m_data.erase(KeyView(key));
 }
 
 Result<JSON&> Object::get(const std::string &key) noexcept {
@@ -111,12 +107,10 @@ Result<Array&> Object::getArray(const String &key) noexcept {
 Result<JSON&> Object::get(const char *const key) noexcept {
     assert(key != nullptr);
 
-    String stringKey(s_keyAllocator);
-    stringKey = key;
-    const Result<JSON&> ret = get(stringKey);
-    s_keyAllocator.reset();
-
-    return ret;
+    const iterator it = m_data.find(KeyView(key));
+    return it != m_data.end()
+        ? Result<JSON&>::fromRef(it->second)
+        : Result<JSON&>::fromError(true);
 }
 
 Result<String&> Object::getString(const char *const key) noexcept {
@@ -141,6 +135,25 @@ Result<const JSON&> Object::get(const std::string &key) const noexcept {
     return get(key.c_str());
 }
 
+Result<JSON&> Object::get(const Key &key) noexcept {
+    const iterator it = m_data.find(key);
+    return it != m_data.end()
+        ? Result<JSON&>::fromRef(it->second)
+        : Result<JSON&>::fromError(true);
+}
+
+Result<String&> Object::getString(const Key &key) noexcept {
+    return getRef<String, &JSON::asString>(key);
+}
+
+Result<Object&> Object::getObject(const Key &key) noexcept {
+    return getRef<Object, &JSON::asObject>(key);
+}
+
+Result<Array&> Object::getArray(const Key &key) noexcept {
+    return getRef<Array, &JSON::asArray>(key);
+}
+
 Result<const String&> Object::getString(const std::string &key) const noexcept {
     return getString(key.c_str());
 }
@@ -208,12 +221,10 @@ Result<bool> Object::getBool(const String &key) const noexcept {
 Result<const JSON&> Object::get(const char *const key) const noexcept {
     assert(key != nullptr);
 
-    String stringKey(s_keyAllocator);
-    stringKey = key;
-    const Result<const JSON&> ret = get(stringKey);
-    s_keyAllocator.reset();
-
-    return ret;
+    const const_iterator it = m_data.find(KeyView(key));
+    return it != m_data.end()
+        ? Result<const JSON&>::fromRef(it->second)
+        : Result<const JSON&>::fromError(true);
 }
 
 Result<const String&> Object::getString(const char *const key) const noexcept {
@@ -248,6 +259,45 @@ Result<bool> Object::getBool(const char *const key) const noexcept {
     return getValue<bool, &JSON::asBool>(key);
 }
 
+Result<const JSON&> Object::get(const Key &key) const noexcept {
+    const const_iterator it = m_data.find(key);
+    return it != m_data.end()
+        ? Result<const JSON&>::fromRef(it->second)
+        : Result<const JSON&>::fromError(true);
+}
+
+Result<const String&> Object::getString(const Key &key) const noexcept {
+    return getConstRef<String, &JSON::asString>(key);
+}
+
+Result<double> Object::getFloat64(const Key &key) const noexcept {
+    return getValue<double, &JSON::asFloat64>(key);
+}
+
+Result<std::int64_t> Object::getInt64(const Key &key) const noexcept {
+    return getValue<std::int64_t, &JSON::asInt64>(key);
+}
+
+Result<std::uint64_t> Object::getUint64(const Key &key) const noexcept {
+    return getValue<std::uint64_t, &JSON::asUint64>(key);
+}
+
+Result<const Object&> Object::getObject(const Key &key) const noexcept {
+    return getConstRef<Object, &JSON::asObject>(key);
+}
+
+Result<const Array&> Object::getArray(const Key &key) const noexcept {
+    return getConstRef<Array, &JSON::asArray>(key);
+}
+
+Result<std::nullptr_t> Object::getNull(const Key &key) const noexcept {
+    return getValue<std::nullptr_t, &JSON::asNull>(key);
+}
+
+Result<bool> Object::getBool(const Key &key) const noexcept {
+    return getValue<bool, &JSON::asBool>(key);
+}
+
 JSON &Object::unsafeGet(const std::string &key) {
     return unsafeGet(key.c_str());
 }
@@ -267,7 +317,7 @@ Array &Object::unsafeGetArray(const std::string &key) {
 JSON &Object::unsafeGet(const String &key) {
     assert(has(key));
 
-    return m_data.at(key);
+    return m_data.find(key)->second;
 }
 
 String &Object::unsafeGetString(const String &key) {
@@ -291,12 +341,9 @@ Array &Object::unsafeGetArray(const String &key) {
 JSON &Object::unsafeGet(const char *const key) {
     assert(key != nullptr);
 
-    String stringKey(s_keyAllocator);
-    stringKey = key;
-    JSON &ret = unsafeGet(stringKey);
-    s_keyAllocator.reset();
+    assert(has(key));
 
-    return ret;
+    return m_data.find(KeyView(key))->second;
 }
 
 String &Object::unsafeGetString(const char *const key) {
@@ -356,11 +403,7 @@ bool Object::unsafeGetBool(const std::string &key) const noexcept {
 const JSON &Object::unsafeGet(const String &key) const noexcept {
     assert(has(key) > 0);
 
-    try {
-        return m_data.at(key);
-    } catch(...) {
-        return JSON::INVALID_JSON;
-    }
+    return (*this)[key];
 }
 
 const String & Object::unsafeGetString (const String &key) const noexcept {
@@ -406,12 +449,9 @@ bool Object::unsafeGetBool(const String &key) const noexcept {
 const JSON &Object::unsafeGet(const char *const key) const noexcept {
     assert(key != nullptr);
 
-    String stringKey(s_keyAllocator);
-    stringKey = key;
-    const JSON &ret = unsafeGet(stringKey);
-    s_keyAllocator.reset();
+    assert(has(key));
 
-    return ret;
+    return (*this)[key];
 }
 
 const String &Object::unsafeGetString(const char *const key) const noexcept {
@@ -557,16 +597,15 @@ bool Object::has(const std::string &key) const noexcept {
 bool Object::has(const char *const key) const noexcept {
     assert(key != nullptr);
 
-    String stringKey(s_keyAllocator);
-    stringKey = key;
-    const bool ret = has(stringKey);
-    s_keyAllocator.reset();
-
-    return ret;
+    return m_data.find(KeyView(key)) != m_data.end();
 }
 
 bool Object::has(const String &key) const noexcept {
-    return m_data.count(key) > 0;
+    return m_data.find(key) != m_data.end();
+}
+
+bool Object::has(const Key &key) const noexcept {
+    return m_data.find(key) != m_data.end();
 }
 
 unsigned Object::size() const noexcept {
@@ -580,12 +619,17 @@ const JSON &Object::operator[](const std::string &key) const noexcept {
 const JSON &Object::operator[](const char *const key) const noexcept {
     assert(key != nullptr);
 
-    String stringKey(s_keyAllocator);
-    stringKey = key;
-    const JSON &ret = (*this)[stringKey];
-    s_keyAllocator.reset();
+    const const_iterator it = m_data.find(KeyView(key));
+    return it != m_data.end()
+        ? it->second
+        : JSON::INVALID_JSON;
+}
 
-    return ret;
+const JSON &Object::operator[](const Key &key) const noexcept {
+    const const_iterator it = m_data.find(key);
+    return it != m_data.end()
+        ? it->second
+        : JSON::INVALID_JSON;
 }
 
 JSON &Object::operator[](const String &key) { 
@@ -597,11 +641,10 @@ JSON &Object::operator[](String &&key) noexcept {
 }
 
 const JSON &Object::operator[](const String &key) const noexcept { 
-    try {
-        return m_data.at(key);
-    } catch(...) {
-        return JSON::INVALID_JSON;
-    }
+    const const_iterator it = m_data.find(key);
+    return it != m_data.end()
+        ? it->second
+        : JSON::INVALID_JSON;
 }
 
 unsigned Object::toStringSize(const unsigned indentation, const unsigned level) const noexcept {
@@ -691,8 +734,4 @@ void Object::destructor() noexcept {
     m_data.~Container();
 }
 
-Object::KeyAllocator &Object::getKeyAllocator() {
-    return s_keyAllocator;
-}
-
 }
\ No newline at end of file
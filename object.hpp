@@ -1,56 +1,109 @@
 #pragma once
 
 #include <cassert>
-#include <unordered_map>
 #include <cstdint>
 #include <cstring>
+#include <string>
 
 #include "allocator.hpp"
+#include "hash.hpp"
+#include "hashmap.hpp"
 #include "string.hpp"
 #include "result.hpp"
 
+//objects with up to this many members compare the keys one after the other instead of hashing them
+#ifndef CPPJSON_SMALL_OBJECT_SIZE
+    #define CPPJSON_SMALL_OBJECT_SIZE 12
+#endif
+
+namespace CPPJSON {
+
+//a key that is looked up in an Object without being copied in a String
+struct KeyView {
+    const char *data;
+    std::size_t length;
+
+    KeyView(const char *const key) noexcept :
+        data  (key),
+        length(std::strlen(key))
+    {}
+
+    KeyView(const std::string &key) noexcept :
+        data  (key.data()),
+        length(key.size())
+    {}
+};
+
+//Object::Key, a key hashed once to be looked up in many objects. It points to the characters of the key
+//so they have to outlive it, a string literal or a std::string that isn't modified
+struct HashedKey : KeyView {
+    std::size_t hash;
+
+    explicit HashedKey(const char *const key) noexcept :
+        KeyView(key),
+        hash   (std::size_t(Hash::hash(data, length)))
+    {}
+
+    explicit HashedKey(const std::string &key) noexcept :
+        KeyView(key),
+        hash   (std::size_t(Hash::hash(data, length)))
+    {}
+};
+
+}
+
+//the lengths are compared before the characters, borrowed keys don't need to be null terminated
 struct StringEqual final {
+    static bool equal(const char *const lhs, const std::size_t lhsLength, const char *const rhs, const std::size_t rhsLength) {
+        return lhsLength == rhsLength && (lhsLength == 0U || lhs == rhs || std::memcmp(lhs, rhs, lhsLength) == 0);
+    }
+
     std::size_t operator()(const char *const lhs, const char *const rhs) const {
-        return lhs == rhs || std::strcmp(lhs, rhs) == 0;
+        return equal(lhs, std::strlen(lhs), rhs, std::strlen(rhs));
     }
 
     std::size_t operator()(const std::string &lhs, const std::string &rhs) const {
-        return (*this)(lhs.c_str(), rhs.c_str());
+        return equal(lhs.data(), lhs.size(), rhs.data(), rhs.size());
     }
 
     std::size_t operator()(const CPPJSON::String &lhs, const CPPJSON::String &rhs) const {
-        return (*this)(lhs.getCString(), rhs.getCString());
+        return equal(lhs.data(), std::size_t(lhs.size()), rhs.data(), std::size_t(rhs.size()));
+    }
+
+    std::size_t operator()(const CPPJSON::String &lhs, const CPPJSON::KeyView &rhs) const {
+        return equal(lhs.data(), std::size_t(lhs.size()), rhs.data, rhs.length);
     }
 };
 
+//hashes data() and size() so a String, a std::string and a KeyView with the same characters have the same hash,
+//it never makes a borrowed key null terminated so reading keys from several threads doesn't modify them.
+//HashMap keeps the hash of every key once it is inserted so a key is only hashed again when it is removed
 struct StringHasher final {
     typedef std::hash<const char*> hash_type;
     typedef void                   is_transparent;
 
-    std::size_t operator()(const char *str) const {
-        assert(std::strlen(str) <= std::size_t(std::numeric_limits<unsigned>().max()));
-
-        unsigned h = 0U;
-        while(*str != '\0') {
-            h += unsigned(*str);
-            h += h << 10;
-            h ^= h >> 6;
-            str++;
-        }
-
-        h += h << 3;
-        h ^= h >> 11;
-        h += h << 15;
+    std::size_t operator()(const char *const str, const std::size_t length) const {
+        return std::size_t(CPPJSON::Hash::hash(str, length));
+    }
 
-        return h;
+    std::size_t operator()(const char *const str) const {
+        return (*this)(str, std::strlen(str));
     }
 
     std::size_t operator()(const std::string &str) const {
-        return (*this)(str.c_str());
+        return (*this)(str.data(), str.size());
     }
 
     std::size_t operator()(const CPPJSON::String &str) const {
-        return (*this)(str.getCString());
+        return (*this)(str.data(), std::size_t(str.size()));
+    }
+
+    std::size_t operator()(const CPPJSON::KeyView &key) const {
+        return (*this)(key.data, key.length);
+    }
+
+    std::size_t operator()(const CPPJSON::HashedKey &key) const {
+        return key.hash;
     }
 };
 
@@ -68,13 +121,14 @@ public:
     typedef std::pair<const KeyType, ValueType> KeyValueType;
     typedef KeyValueType                        ContainerType;
     typedef ArenaAllocator<ContainerType>       Allocator;
-    typedef ArenaAllocator<KeyType>             KeyAllocator;
-    typedef std::unordered_map<
+    typedef HashedKey                           Key;
+    typedef HashMap<
         KeyType,
         ValueType,
         StringHasher,
         StringEqual,
-        Allocator
+        Allocator,
+        CPPJSON_SMALL_OBJECT_SIZE
     > Container;
 
     typedef Container::iterator       iterator;
@@ -90,6 +144,7 @@ public:
     Object &operator=(const Object&);
     Object &operator=(Object&&)      noexcept;
     
+    //room for exactly capacity members, 0 reserves MINIMUM_CAPACITY
     bool reserve(unsigned capacity = 0U) noexcept;
     void remove (const std::string&)     noexcept;
     void remove (const String&)          noexcept;
@@ -107,6 +162,10 @@ public:
     Result<String&> getString(const char*)        noexcept;
     Result<Object&> getObject(const char*)        noexcept;
     Result<Array&>  getArray (const char*)        noexcept;
+    Result<JSON&>   get      (const Key&)         noexcept;
+    Result<String&> getString(const Key&)         noexcept;
+    Result<Object&> getObject(const Key&)         noexcept;
+    Result<Array&>  getArray (const Key&)         noexcept;
          
     Result<const JSON&>    get       (const std::string&) const noexcept;
     Result<const String&>  getString (const std::string&) const noexcept;
@@ -135,6 +194,15 @@ public:
     Result<const Array&>   getArray  (const char*)        const noexcept;
     Result<std::nullptr_t> getNull   (const char*)        const noexcept;
     Result<bool>           getBool   (const char*)        const noexcept;
+    Result<const JSON&>    get       (const Key&)         const noexcept;
+    Result<const String&>  getString (const Key&)         const noexcept;
+    Result<double>         getFloat64(const Key&)         const noexcept;
+    Result<std::int64_t>   getInt64  (const Key&)         const noexcept;
+    Result<std::uint64_t>  getUint64 (const Key&)         const noexcept;
+    Result<const Object&>  getObject (const Key&)         const noexcept;
+    Result<const Array&>   getArray  (const Key&)         const noexcept;
+    Result<std::nullptr_t> getNull   (const Key&)         const noexcept;
+    Result<bool>           getBool   (const Key&)         const noexcept;
         
     JSON   &unsafeGet      (const std::string&);
     String &unsafeGetString(const std::string&);
@@ -203,6 +271,7 @@ public:
     bool     has (const std::string&) const noexcept;
     bool     has (const char*)        const noexcept;
     bool     has (const String&)      const noexcept;
+    bool     has (const Key&)         const noexcept;
     unsigned size() const noexcept;
 
     const JSON& operator[](const std::string&) const noexcept;
@@ -210,6 +279,7 @@ public:
     JSON&       operator[](const String&);
     JSON&       operator[](String&&)                 noexcept;
     const JSON& operator[](const String&)      const noexcept;
+    const JSON& operator[](const Key&)         const noexcept;
 
     void toString        (std::string&, unsigned indentation, unsigned level) const noexcept;
     unsigned toStringSize(unsigned indentation, unsigned level)               const noexcept;
@@ -223,12 +293,8 @@ public:
 
     void destructor() noexcept;
 
-    static KeyAllocator &getKeyAllocator();
-    
 private:
     Container m_data;
-    static Arena        s_keyArena;
-    static KeyAllocator s_keyAllocator;
 
     template<typename T, Result<T&>(JSON::*method)()>
     Result<T&> getRef(const char *const key) noexcept {
@@ -290,6 +356,36 @@ private:
         return (jsonResult.getRef().*method)();
     }
 
+    template<typename T, Result<T&>(JSON::*method)()>
+    Result<T&> getRef(const Key &key) noexcept {
+        const Result<JSON&> jsonResult = get(key);
+        if(!jsonResult.isSuccess()) {
+            return Result<T&>::fromError(true);
+        }
+
+        return (jsonResult.getRef().*method)();
+    }
+
+    template<typename T, Result<const T&>(JSON::*method)() const>
+    Result<const T&> getConstRef(const Key &key) const noexcept {
+        const Result<const JSON&> jsonResult = get(key);
+        if(!jsonResult.isSuccess()) {
+            return Result<const T&>::fromError(true);
+        }
+
+        return (jsonResult.getRef().*method)();
+    }
+
+    template<typename T, Result<T>(JSON::*method)() const>
+    Result<T> getValue(const Key &key) const noexcept {
+        const Result<const JSON&> jsonResult = get(key);
+        if(!jsonResult.isSuccess()) {
+            return Result<T>::fromError(true);
+        }
+
+        return (jsonResult.getRef().*method)();
+    }
+
     template<typename T>
     bool setValue(const String &key, const T value) noexcept {
         try {
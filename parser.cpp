@@ -1,110 +1,129 @@
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstring>
 #include <limits>
 #include <new>
+#include <thread>
+#include <vector>
 
 #include "parser.hpp"
 #include "util.hpp"
+#include "number.hpp"
 #include "file.hpp"
 #include "lexer.hpp"
+#include "simd.hpp"
+#include "lines.hpp"
 
 namespace CPPJSON {
 
-Error Parser::parseToken(JSON &json, Tokens &tokens) noexcept {
-    switch(tokens.currentToken->type) {
-    case Token::Type::STRING: 
-        return parseString(json, tokens);
-    
-    case Token::Type::INT:
-    case Token::Type::FLOAT:
-    case Token::Type::SCIENTIFIC_INT: 
-        return parseNumber(json, tokens);
-    
-    case Token::Type::BOOL: 
-        parseBool(json, tokens);
-        return Error::NONE;
-    
-    case Token::Type::NUL: 
-        parseNull(json, tokens);
-        return Error::NONE;
-    
-    case Token::Type::LBRACKET: 
-        return parseArray(json, tokens);
-    
-    case Token::Type::LCURLY:
-        return parseObject(json, tokens);
-    
-    case Token::Type::COLON:
-    case Token::Type::COMMA:
-    case Token::Type::RBRACKET:
-    case Token::Type::RCURLY:
-    case Token::Type::INVALID:
-    case Token::Type::DONE:
-        return Error::TOKEN;
+//the counters of inputs past 4 GB don't fit in an arena node, the arenas are sized up to MAX_ARENA_RESERVE bytes
+//and grow past it as values are allocated
+template<typename T>
+static unsigned arenaCount(const std::size_t count) noexcept {
+    static const std::size_t MAX_ARENA_RESERVE = std::size_t(1U) << 30;
+
+    return unsigned(std::min(count, MAX_ARENA_RESERVE / sizeof(T)));
+}
+
+//the token length saturates at Token::MAX_LENGTH, longer strings have to be measured again
+std::size_t Parser::stringLength(const char *const value, const Token &token) noexcept {
+    if(token.getLength() < Token::MAX_LENGTH) {
+        return token.getLength();
     }
 
-    return Error::NONE;
+    //the lexer already found the closing quote
+    bool escaping = false;
+    for(std::size_t i = 1U;; i++) {
+        const char c = value[i];
+
+        if(c == '\\' && !escaping) {
+            escaping = true;
+        } else if(escaping) {
+            escaping = false;
+        } else if(c == '"') {
+            return i + 1U;
+        }
+    }
 }
 
-bool Parser::decodeStringToken(String &str, Token &token) noexcept {
-    const char *const inputEnd     = token.value + token.length - 2;
-    const char       *inputCurrent = token.value + 1;
-    bool              escaping      = false;
+//writes a decoded string over its own token, the output never gets ahead of the input
+struct InSituWriter {
+    char *current;
+
+    void push(const char c) noexcept {
+        *current++ = c;
+    }
+
+    void append(const char *const str, const unsigned length) noexcept {
+        if(current != str) {
+            std::memmove(current, str, std::size_t(length));
+        }
+        current += length;
+    }
+
+    InSituWriter &operator+=(const char *str) noexcept {
+        while(*str != '\0') {
+            *current++ = *str++;
+        }
+        return *this;
+    }
+};
+
+template<typename TString>
+bool Parser::decodeStringToken(TString &str, const char *const value, const unsigned length) noexcept {
+    const char *const inputEnd     = value + length - 2;
+    const char       *inputCurrent = value + 1;
 
     while(inputCurrent != inputEnd + 1) {
-        if(Util::isControlChar(*inputCurrent)) {
+        //copies everything up to the next escape sequence at once
+        const unsigned run = unsigned(Simd::findBackslashOrControlChar(inputCurrent, std::size_t(inputEnd + 1 - inputCurrent)));
+        str.append(inputCurrent, run);
+        inputCurrent += run;
+
+        if(inputCurrent == inputEnd + 1) {
+            break;
+        }
+
+        if(*inputCurrent != '\\') {
             return false;
         }
 
-        if(!escaping) {
-            if(*inputCurrent == '\\') {
-                escaping = true;
-                inputCurrent++;
-                continue;
-            }
+        inputCurrent++;
+        if(inputCurrent == inputEnd + 1) {
+            return false;
+        }
 
-            str.push(*(inputCurrent++));
-            continue;
-        } 
-        
         switch(*inputCurrent) {
         case '"':
-            escaping = false;
             str.push('"');
             inputCurrent++;
             continue;
         case 'b':
-            escaping = false;
             str.push('\b');
             inputCurrent++;
             continue;
         case 'f':
-            escaping = false;
             str.push('\f');
             inputCurrent++;
             continue;
         case 'n':
-            escaping = false;
             str.push('\n');
             inputCurrent++;
             continue;
         case 'r':
-            escaping = false;
             str.push('\r');
             inputCurrent++;
             continue;
         case 't':
-            escaping = false;
             str.push('\t');
             inputCurrent++;
             continue;
         case '/':
-            escaping = false;
             str.push('/');
             inputCurrent++;
             continue;
         case '\\': {
-            escaping = false;
             str.push('\\');
             inputCurrent++;
             continue;
@@ -126,9 +145,8 @@ bool Parser::decodeStringToken(String &str, Token &token) noexcept {
             }
 
             if(Util::isValidUtf16(high)) {
-                str           += Util::utf16ToUtf8(utf8Str, high);
+                str          += Util::utf16ToUtf8(utf8Str, high);
                 inputCurrent += 4;
-                escaping       = false;
                 continue;
             }
 
@@ -143,229 +161,294 @@ bool Parser::decodeStringToken(String &str, Token &token) noexcept {
             
             str          += Util::utf16ToUtf8(utf8Str, high, low);
             inputCurrent += 10;
-            escaping      = false;
             continue;
         }
         default:
             return false;        
-    }
+        }
     }
 
-    return !escaping;
+    return true;
 }
 
-Error Parser::parseString(JSON &json, Tokens &tokens) noexcept {
-    assert(tokens.currentToken != nullptr);
+//decodes into a std::string with the interface decodeStringToken expects
+struct StdStringWriter {
+    std::string &str;
 
-    Result<String&> stringResult = json.makeString(getStringAllocator()); 
-    assert(stringResult.isSuccess());
-    String &string = stringResult.getRef();
-    if(!string.reserve(tokens.currentToken->length - 1U)) {
-        return Error::MEMORY;
+    void push(const char c) {
+        str.push_back(c);
     }
 
-    if(!decodeStringToken(string, *tokens.currentToken)) {
-        return Error::STRING;
+    void append(const char *const data, const unsigned length) {
+        str.append(data, std::size_t(length));
     }
 
-    tokens.currentToken++;
-    return Error::NONE;
-}
-
-Error Parser::parseArray(JSON &json, Tokens &tokens) noexcept {
-    assert(tokens.currentToken != nullptr);
-    
-    const unsigned length = tokens.currentToken->length;
-
-    tokens.currentToken++;
-
-    const Token *const lastToken = tokens.data.data() + tokens.data.size() - 1;
-    if(tokens.currentToken == lastToken) {
-        return Error::ARRAY;
-    }
-    
-    const Result<Array&> arrayResult = json.makeArray(getArrayAllocator());
-    assert(arrayResult.isSuccess());
-    Array &array = arrayResult.getRef();
-    if(!array.reserve(length)) {
-        return Error::MEMORY;
+    StdStringWriter &operator+=(const char *const data) {
+        str += data;
+        return *this;
     }
+};
 
-    if(tokens.currentToken->type == Token::Type::RBRACKET) {
-        tokens.currentToken++;
-        return Error::NONE;
+bool Parser::decodeStringToken(std::string &str, const char *const value, const unsigned length) noexcept {
+    try {
+        str.reserve(std::size_t(length - 2U));
+        StdStringWriter writer = {str};
+        return decodeStringToken(writer, value, length);
+    } catch(...) {
+        return false;
     }
+}
 
-    while(lastToken - tokens.currentToken >= 2) {
-        array.push();
-        JSON &nextJSON = array.unsafeBack();
-        const Error error = parseToken(nextJSON, tokens);
-        if(error == Error::TOKEN) {
-            return Error::ARRAY_VALUE;
-        } 
-        if(error != Error::NONE) {
-            return error;
+Error Parser::decodeString(String &string, const char *const value, const std::size_t tokenLength, const bool isKey) noexcept {
+    //inputs can be larger than 4 GB but a single string can't
+    if(tokenLength >= std::size_t(std::numeric_limits<unsigned>::max())) {
+        return Error::TOO_LARGE;
+    }
+    const unsigned length = unsigned(tokenLength);
+
+    switch(m_stringMode) {
+    case StringMode::IN_SITU: {
+        char *const destination = const_cast<char*>(value + 1);
+        InSituWriter writer = {destination};
+        if(!decodeStringToken(writer, value, length)) {
+            return Error::STRING;
         }
 
-        if(tokens.currentToken->type == Token::Type::COMMA) {
-            tokens.currentToken++;
-            continue;
-        }
+        //there is at least the closing quote left to overwrite
+        *writer.current = '\0';
+        string.borrow(destination, unsigned(writer.current - destination), true);
+        return Error::NONE;
+    }
 
-        if(tokens.currentToken->type == Token::Type::RBRACKET) {
-            tokens.currentToken++;
+    case StringMode::BORROW:
+        //without escape sequences the decoded string is the token itself. Keys are copied because the map only
+        //hands them out as const Strings, which can't be materialized so getCString needs them null terminated
+        if(!isKey && Simd::findBackslashOrControlChar(value + 1, length - 2U) == length - 2U) {
+            string.borrow(value + 1, length - 2U);
             return Error::NONE;
         }
+        break;
 
-        return Error::MISSING_COMMA_OR_RBRACKET;
+    case StringMode::COPY:
+        break;
     }
 
-    return Error::ARRAY;
+    if(!string.reserve(length - 1U)) {
+        return Error::MEMORY;
+    }
+
+    return decodeStringToken(string, value, length) ? Error::NONE : Error::STRING;
 }
 
-Error Parser::parseObject(JSON &json, Tokens &tokens) noexcept {
-    assert(tokens.currentToken != nullptr);
+Error Parser::decodeEventString(const char *const value, const Token &token, const char *&str, unsigned &length) noexcept {
+    const std::size_t fullLength = stringLength(value, token);
+    if(fullLength >= std::size_t(std::numeric_limits<unsigned>::max())) {
+        return Error::TOO_LARGE;
+    }
+    const unsigned tokenLength = unsigned(fullLength);
 
-    const unsigned length = tokens.currentToken->length;
+    //without escape sequences the string is passed straight from the input
+    if(Simd::findBackslashOrControlChar(value + 1, tokenLength - 2U) == tokenLength - 2U) {
+        str    = value + 1;
+        length = tokenLength - 2U;
+        return Error::NONE;
+    }
 
-    tokens.currentToken++;
-    assert(tokens.currentToken != nullptr);
-    
-    const Token *const lastToken = tokens.data.data() + tokens.data.size() - 1;
-    if(tokens.currentToken == lastToken) {
-        return Error::OBJECT;
+    m_eventString.clear();
+    if(!decodeStringToken(m_eventString, value, tokenLength)) {
+        return Error::STRING;
     }
 
-    Result<Object&> objectResult = json.makeObject(getObjectAllocator());
-    assert(objectResult.isSuccess());
-    Object &object = objectResult.getRef();
-    if(!object.reserve(length)) {
-        return Error::MEMORY;
+    str    = m_eventString.data();
+    length = unsigned(m_eventString.size());
+    return Error::NONE;
+}
+
+bool Parser::pushContainer(JSON &json) noexcept {
+    try {
+        m_stack.push_back(&json);
+        return true;
+    } catch(...) {
+        return false;
     }
+}
 
-    if(tokens.currentToken->type == Token::Type::RCURLY) {
-        tokens.currentToken++;
-        return Error::NONE;
+class Parser::DomBuilder {
+    Parser &m_parser;
+    //the value the next token is parsed into
+    JSON   *m_json;
+    String  m_key;
+
+public:
+    DomBuilder(Parser &owner, JSON &root) :
+        m_parser(owner),
+        m_json(&root),
+        m_key(owner.getStringAllocator())
+    {
+        m_parser.m_stack.clear();
     }
 
-    while(lastToken - tokens.currentToken >= 4) {
-        if(tokens.currentToken->type != Token::Type::STRING) {
-            return Error::OBJECT_KEY;
-        }
+    Error string(const char *const value, const Token &token) noexcept {
+        Result<String&> stringResult = m_json->makeString(m_parser.getStringAllocator()); 
+        assert(stringResult.isSuccess());
+        return m_parser.decodeString(stringResult.getRef(), value, stringLength(value, token), false);
+    }
 
-        String key(getStringAllocator());
-        if(!decodeStringToken(key, *tokens.currentToken)) {
-            return Error::OBJECT_KEY;
-        }
+    Error number(const char *const value, const Token &token) noexcept {
+        return decodeNumber(*m_json, value, token);
+    }
 
-        tokens.currentToken++;
-    
-        if(tokens.currentToken->type != Token::Type::COLON) {
-            return Error::MISSING_COLON;
-        }
+    void boolean(const bool value) noexcept {
+        m_json->set(value);
+    }
 
-        tokens.currentToken++;
+    void null() noexcept {
+        m_json->set();
+    }
 
-        JSON &nextJSON = object[std::move(key)];
-        const Error error = parseToken(nextJSON, tokens);
-        if(error == Error::TOKEN) {
-            return Error::OBJECT_VALUE;
-        }
-        if(error != Error::NONE) {
-            return error;
+    Error open(const bool isArray, const unsigned length) noexcept {
+        if(isArray) {
+            const Result<Array&> arrayResult = m_json->makeArray(m_parser.getArrayAllocator());
+            assert(arrayResult.isSuccess());
+            if(!arrayResult.getRef().reserve(length)) {
+                return Error::MEMORY;
+            }
+        } else {
+            const Result<Object&> objectResult = m_json->makeObject(m_parser.getObjectAllocator());
+            assert(objectResult.isSuccess());
+            if(!objectResult.getRef().reserve(length)) {
+                return Error::MEMORY;
+            }
         }
 
-        if(tokens.currentToken->type == Token::Type::COMMA) {
-            tokens.currentToken++;
-            continue;
-        }
+        return m_parser.pushContainer(*m_json) ? Error::NONE : Error::MEMORY;
+    }
 
-        if(tokens.currentToken->type == Token::Type::RCURLY) {
-            tokens.currentToken++;
-            return Error::NONE;
-        }
+    void close(bool) noexcept {
+        m_parser.m_stack.pop_back();
+    }
 
-        return Error::MISSING_COMMA_OR_RCURLY;
+    //adds an element to the innermost array
+    void element() noexcept {
+        Array &array = m_parser.m_stack.back()->unsafeAsArray();
+        array.push();
+        m_json = &array.unsafeBack();
     }
-    
-    return Error::OBJECT;
+
+    Error decodeKey(const char *const value, const Token &token) noexcept {
+        m_key = String(m_parser.getStringAllocator());
+        return m_parser.decodeString(m_key, value, stringLength(value, token), true);
+    }
+
+    void key() noexcept {
+        m_json = &m_parser.m_stack.back()->unsafeAsObject()[std::move(m_key)];
+    }
+};
+
+template<typename TTokens>
+Error Parser::parseToken(JSON &root, TTokens &tokens) noexcept {
+    DomBuilder builder(*this, root);
+    return parseValue(tokens, builder);
 }
 
-Error Parser::parseNumber(JSON &json, Tokens &tokens) noexcept {
-    assert(tokens.currentToken != nullptr);
+Error Parser::decodeNumber(JSON &json, const char *const value, const Token &token) noexcept {
+    static const unsigned MAX_LENGTH = 1U << 9;
 
     bool success;
-    char number[1 << 9] = {};
 
-    Token &token = *tokens.currentToken;
-    if(std::size_t(token.length) >= sizeof(number)) {
+    if(token.getLength() >= MAX_LENGTH) {
         return Error::TOO_LARGE;
     }
 
-    std::memcpy(number, token.value, std::size_t(token.length));
+    const unsigned length = token.getLength();
 
-    if(token.type == Token::Type::FLOAT) {
-        const double value = Util::parseFloat64(number, success);
+    if(token.getType() == Token::Type::FLOAT) {
+        const double result = Number::parseFloat64(value, length, success);
         if(!success) {
             return Error::FLOAT64;
         }
-        json.set(value);
-    } else if(number[0] == '-') {
-        if(token.type == Token::Type::SCIENTIFIC_INT) {
-            const long double value = Util::parseLongDouble(number, success);
-            if(!success 
-            || value < (long double)(std::numeric_limits<std::int64_t>::min()) 
-            || value > (long double)(std::numeric_limits<std::int64_t>::max())
-            ){
+        json.set(result);
+    } else if(token.getType() == Token::Type::SCIENTIFIC_INT) {
+        //1e5 is an integer but 1.5e0 and 1e-5 aren't
+        bool integral;
+        if(value[0] == '-') {
+            const std::int64_t result = Number::parseScientificInt64(value, length, integral, success);
+            if(success) {
+                json.set(result);
+            } else if(integral) {
                 return Error::INT64;
             }
-            json.set(std::int64_t(value));
         } else {
-            const std::int64_t value = Util::parseInt64(number, success);
+            const std::uint64_t result = Number::parseScientificUint64(value, length, integral, success);
+            if(success) {
+                json.set(result);
+            } else if(integral) {
+                return Error::UINT64;
+            }
+        }
+
+        if(!integral) {
+            const double result = Number::parseFloat64(value, length, success);
             if(!success) {
-                return Error::INT64;
+                return Error::FLOAT64;
             }
-            json.set(value);
+            json.set(result);
         }
-    } else if(token.type == Token::Type::SCIENTIFIC_INT) {
-        const long double value = Util::parseLongDouble(number, success);
-        if(!success || value > (long double)(std::numeric_limits<std::uint64_t>::max())) {
-            return Error::UINT64;
+    } else if(value[0] == '-') {
+        const std::int64_t result = Number::parseInt64(value, length, success);
+        if(!success) {
+            return Error::INT64;
         }
-        json.set(std::uint64_t(value));
+        json.set(result);
     } else {
-        const uint64_t value = Util::parseUint64(number, success);
+        const std::uint64_t result = Number::parseUint64(value, length, success);
         if(!success) {
             return Error::UINT64;
         }
-        json.set(value);
+        json.set(result);
     }
 
-    tokens.currentToken++;
-    
     return Error::NONE;
 }
 
-void Parser::parseNull(JSON &json, Tokens &tokens) noexcept {
-    assert(tokens.currentToken != nullptr);
+Parser::Parser() noexcept {}
 
-    json.set();
-    tokens.currentToken++;
-}
+Parser::Parser(const Options &options) noexcept :
+    m_options(options)
+{}
 
-void Parser::parseBool(JSON &json, Tokens &tokens) noexcept {
-    assert(tokens.currentToken != nullptr);
+Parser::~Parser() noexcept {
+    for(RootNode *current = m_firstRoot; current != nullptr; current = current->next) {
+        current->json.~JSON();
+    }
+}
 
-    json.set(tokens.currentToken->value[0] == 't');
-    tokens.currentToken++;
+void Parser::setOptions(const Options &options) noexcept {
+    m_options = options;
 }
 
-Parser::Parser() noexcept {}
+const Parser::Options &Parser::getOptions() const noexcept {
+    return m_options;
+}
 
-Parser::~Parser() noexcept {
+//destroys every JSON returned so far and rewinds the arenas, their memory is reused by the next parses
+void Parser::reset() noexcept {
     for(RootNode *current = m_firstRoot; current != nullptr; current = current->next) {
         current->json.~JSON();
     }
+    m_firstRoot   = nullptr;
+    m_currentRoot = nullptr;
+
+    if(m_arenas != nullptr) {
+        m_arenas->object.reset();
+        m_arenas->array.reset();
+        m_arenas->string.reset();
+        m_arenas->root.reset();
+    }
+
+    for(ParserPtr &child : m_children) {
+        child->reset();
+    }
 }
 
 ParserResult Parser::init() noexcept {
@@ -387,30 +470,355 @@ ParserResult Parser::init() noexcept {
 ParserResult Parser::parse(const std::string &data) noexcept {
     assert(data[0] != '\0');
 
-    if(data.size() >= std::size_t(std::numeric_limits<unsigned>::max())) {
-        return ParserResult::fromError(Error::TOO_LARGE);
-    }
-
-    return parse(data.c_str(), unsigned(data.size()));
+    return parse(data.c_str(), data.size());
 }
 
 ParserResult Parser::parse(const char *const data) noexcept {
     assert(data != nullptr);
     assert(data[0] != '\0');
 
-    const size_t length = std::strlen(data);
-    if(length >= std::size_t(std::numeric_limits<unsigned>::max())) {
-        return ParserResult::fromError(Error::TOO_LARGE);
+    return parse(data, std::strlen(data));
+}
+
+ParserResult Parser::parse(const char *const data, const std::size_t length) noexcept {
+    return parseBuffer(data, length, m_options.borrowStrings);
+}
+
+ParserResult Parser::parseBuffer(const char *const data, const std::size_t length, const bool borrowStrings) noexcept {
+    assert(data != nullptr);
+    assert(length > 0);
+
+    m_stringMode = borrowStrings ? StringMode::BORROW : StringMode::COPY;
+
+    if(m_options.fused) {
+        return parseFused(data, length);
+    }
+
+    return parseTokens(data, length);
+}
+
+Parser *Parser::lineParser() noexcept {
+    if(m_lineParser == nullptr) {
+        m_lineParser.reset(new(std::nothrow) Parser());
+        if(m_lineParser == nullptr) {
+            return nullptr;
+        }
+    }
+    m_lineParser->setOptions(m_options);
+
+    return m_lineParser.get();
+}
+
+//parses a record into this parser, which is always the line parser of another one
+Error Parser::parseLine(const char *const data, const std::size_t length, const LineCallback &callback, std::size_t &records) noexcept {
+    std::size_t i = 0U;
+    for(; i < length && Util::isWhitespace(data[i]); i++);
+    if(i == length) {
+        return Error::NONE;
+    }
+
+    const ParserResult parserResult = parse(data, length);
+    if(parserResult.isSuccess()) {
+        callback(parserResult.getRef());
+        records++;
     }
+    reset();
 
-    return parse(data, unsigned(length));
+    return parserResult.isSuccess() ? Error::NONE : parserResult.getError();
 }
 
-ParserResult Parser::parse(const char *const data, const unsigned length) noexcept {
+ParserResult Parser::parseParallel(const std::string &data, const unsigned threads) noexcept {
+    assert(data[0] != '\0');
+
+    return parseParallel(data.c_str(), data.size(), threads);
+}
+
+ParserResult Parser::parseParallel(const char *const data, const std::size_t length, const unsigned threads) noexcept {
+    return parseParallelArray(data, length, threads, m_options.borrowStrings);
+}
+
+ParserResult Parser::parseFileParallel(const std::string &path, const unsigned threads) noexcept {
+    return parseFileParallel(path.c_str(), threads);
+}
+
+ParserResult Parser::parseFileParallel(const char *const path, const unsigned threads) noexcept {
+    assert(path != nullptr);
+    assert(path[0] != '\0');
+
+    FileContents fileContents = FileContents::get(path);
+    if(fileContents.getError() != FileContents::Error::NONE) {
+        return ParserResult::fromError(Error::FILE);
+    }
+
+    return parseParallelArray(reinterpret_cast<const char*>(fileContents.getData()), fileContents.getLength(), threads, false);
+}
+
+//every element is parsed on its own by the child parser of its thread then moved in the array of this parser.
+//Anything unexpected is parsed again by parseBuffer so errors are the same as parse
+ParserResult Parser::parseParallelArray(const char *const data, const std::size_t length, unsigned threads, const bool borrowStrings) noexcept {
+    static const std::size_t MINIMUM_LENGTH = std::size_t(1U) << 20;
+
+    assert(data != nullptr);
+    assert(length > 0U);
+
+    if(threads == 0U) {
+        threads = std::thread::hardware_concurrency();
+    }
+    //the elements are one level deeper than their own root, a depth of 1 can't be checked on them
+    if(threads <= 1U || length < MINIMUM_LENGTH || m_options.maxDepth == 1U) {
+        return parseBuffer(data, length, borrowStrings);
+    }
+
+    typedef std::vector<JSON*, GeneralAllocator<JSON*>>             Values;
+    typedef std::vector<std::size_t, GeneralAllocator<std::size_t>> Parts;
+
+    StructuralScanner::Spans elements{0, GeneralAllocator<StructuralScanner::Span>()};
+    Values                   values  {0, GeneralAllocator<JSON*>()};
+    //the index of the first element of each part, parts have about the same number of bytes
+    Parts                    parts   {0, GeneralAllocator<std::size_t>()};
+    try {
+        if(!StructuralScanner::splitArray(data, length, elements) || elements.size() < std::size_t(threads) * 2U ||
+           elements.size() >= std::size_t(std::numeric_limits<unsigned>::max())) {
+            return parseBuffer(data, length, borrowStrings);
+        }
+
+        values.resize(elements.size());
+        parts.reserve(std::size_t(threads) + 1U);
+        parts.push_back(0U);
+        for(std::size_t i = 1U; i < elements.size() && parts.size() < std::size_t(threads); i++) {
+            if(std::uint64_t(elements[i].start) * threads >= std::uint64_t(length) * parts.size()) {
+                parts.push_back(i);
+            }
+        }
+        parts.push_back(elements.size());
+
+        while(m_children.size() < parts.size() - 1U) {
+            m_children.emplace_back(new(std::nothrow) Parser());
+            if(m_children.back() == nullptr) {
+                m_children.pop_back();
+                return parseBuffer(data, length, borrowStrings);
+            }
+        }
+    } catch(...) {
+        return parseBuffer(data, length, borrowStrings);
+    }
+
+    Options options = m_options;
+    if(options.maxDepth != 0U) {
+        options.maxDepth--;
+    }
+
+    std::atomic<bool> failed{false};
+    const auto parsePart = [&](const std::size_t part) noexcept {
+        Parser &child = *m_children[part];
+        child.setOptions(options);
+
+        for(std::size_t i = parts[part]; i < parts[part + 1U] && !failed.load(std::memory_order_relaxed); i++) {
+            const ParserResult parserResult = child.parseBuffer(data + elements[i].start, elements[i].length, borrowStrings);
+            if(!parserResult.isSuccess()) {
+                failed.store(true, std::memory_order_relaxed);
+                return;
+            }
+            values[i] = &parserResult.getRef();
+        }
+    };
+
+    //the calling thread takes the first part and the parts of the threads that couldn't be started
+    std::vector<std::thread> workers;
+    std::size_t part = 1U;
+    try {
+        workers.reserve(parts.size() - 2U);
+        for(; part + 1U < parts.size(); part++) {
+            workers.emplace_back(parsePart, part);
+        }
+    } catch(...) {}
+
+    parsePart(0U);
+    for(; part + 1U < parts.size(); part++) {
+        parsePart(part);
+    }
+    for(std::thread &worker : workers) {
+        worker.join();
+    }
+
+    if(failed.load(std::memory_order_relaxed)) {
+        return parseBuffer(data, length, borrowStrings);
+    }
+
+    if(m_arenas == nullptr) {
+        const ArenaSizes arenaSizes = {0U, 0U, 0U, 0U};
+        if(!initArenas(arenaSizes, Arena::INFINITE_NODES)) {
+            return ParserResult::fromError(Error::MEMORY);
+        }
+    }
+
+    RootNode *const rootNode = newRootNode();
+    if(rootNode == nullptr) {
+        return ParserResult::fromError(Error::MEMORY);
+    }
+
+    const Result<Array&> arrayResult = rootNode->json.makeArray(getArrayAllocator());
+    assert(arrayResult.isSuccess());
+    Array &array = arrayResult.getRef();
+    if(!array.reserve(unsigned(values.size()))) {
+        return ParserResult::fromError(Error::MEMORY);
+    }
+
+    for(JSON *const value : values) {
+        array.push();
+        array.unsafeBack().set(std::move(*value));
+    }
+
+    return ParserResult::fromRef(rootNode->json);
+}
+
+Parser::LinesResult Parser::parseLines(const std::string &data, const LineCallback &callback, const unsigned threads) noexcept {
+    return parseLines(data.data(), data.size(), callback, threads);
+}
+
+//JSON strings can't contain raw newlines, every '\n' ends a record
+Parser::LinesResult Parser::parseLines(const char *const data, const std::size_t length, const LineCallback &callback, const unsigned threads) noexcept {
+    assert(data != nullptr || length == 0U);
+
+    if(threads != 1U) {
+        return LinesWorkers(m_options, threads).parse(data, length, callback);
+    }
+
+    LinesResult result;
+    Parser *const parser = lineParser();
+    if(parser == nullptr) {
+        result.error = Error::MEMORY;
+        return result;
+    }
+
+    const char *const end     = data + length;
+    const char       *current = data;
+
+    while(current != end) {
+        const char *newline = static_cast<const char*>(std::memchr(current, '\n', std::size_t(end - current)));
+        if(newline == nullptr) {
+            newline = end;
+        }
+
+        result.error = parser->parseLine(current, std::size_t(newline - current), callback, result.records);
+        if(result.error != Error::NONE) {
+            result.offset = std::uint64_t(current - data);
+            return result;
+        }
+
+        current = newline == end ? end : newline + 1;
+    }
+
+    return result;
+}
+
+Parser::LinesResult Parser::parseLinesFile(const std::string &path, const LineCallback &callback, const unsigned threads) noexcept {
+    return parseLinesFile(path.c_str(), callback, threads);
+}
+
+Parser::LinesResult Parser::parseLinesFile(const char *const path, const LineCallback &callback, const unsigned threads) noexcept {
+    static const std::size_t CHUNK_SIZE = std::size_t(1U) << 20;
+
+    assert(path != nullptr);
+    assert(path[0] != '\0');
+
+    if(threads != 1U) {
+        return LinesWorkers(m_options, threads).parseFile(path, callback);
+    }
+
+    LinesResult result;
+    Parser *const parser = lineParser();
+    if(parser == nullptr) {
+        result.error = Error::MEMORY;
+        return result;
+    }
+
+    FileStream file;
+    if(file.open(path) != FileContents::Error::NONE) {
+        result.error = Error::FILE;
+        return result;
+    }
+
+    //[begin, end) holds the unparsed part of the file, it only grows to fit the largest record
+    std::vector<char, GeneralAllocator<char>> buffer{0, GeneralAllocator<char>()};
+    try {
+        buffer.resize(CHUNK_SIZE);
+    } catch(...) {
+        result.error = Error::MEMORY;
+        return result;
+    }
+
+    std::uint64_t bufferOffset = 0U;
+    std::size_t   begin        = 0U,
+                  scanned      = 0U,
+                  end          = 0U;
+    bool          endOfFile    = false;
+
+    for(;;) {
+        const char *const newline = static_cast<const char*>(std::memchr(buffer.data() + scanned, '\n', end - scanned));
+        if(newline != nullptr || (endOfFile && begin != end)) {
+            const std::size_t recordEnd = newline == nullptr ? end : std::size_t(newline - buffer.data());
+
+            result.error = parser->parseLine(buffer.data() + begin, recordEnd - begin, callback, result.records);
+            if(result.error != Error::NONE) {
+                result.offset = bufferOffset + begin;
+                return result;
+            }
+
+            begin   = newline == nullptr ? end : recordEnd + 1U;
+            scanned = begin;
+            continue;
+        }
+
+        if(endOfFile) {
+            return result;
+        }
+
+        //moves the partial record to the front and makes room for the next chunk
+        scanned = end;
+        if(begin != 0U) {
+            std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+            bufferOffset += begin;
+            end          -= begin;
+            scanned      -= begin;
+            begin         = 0U;
+        }
+        if(buffer.size() - end < CHUNK_SIZE / 2U) {
+            try {
+                buffer.resize(buffer.size() * 2U);
+            } catch(...) {
+                result.error  = Error::MEMORY;
+                result.offset = bufferOffset;
+                return result;
+            }
+        }
+
+        const std::size_t read = file.read(buffer.data() + end, buffer.size() - end);
+        if(read == 0U) {
+            if(file.hasError()) {
+                result.error  = Error::FILE;
+                result.offset = bufferOffset;
+                return result;
+            }
+            endOfFile = true;
+        }
+        end += read;
+    }
+}
+
+ParserResult Parser::parseInPlace(char *const data, const std::size_t length) noexcept {
     assert(data != nullptr);
     assert(length > 0);
 
-    Tokens tokens;
+    m_stringMode = StringMode::IN_SITU;
+
+    //always tokenizes first, the fused lexer would scan strings that were already decoded over
+    return parseTokens(data, length);
+}
+
+ParserResult Parser::parseTokens(const char *const data, const std::size_t length) noexcept {
+    Tokens &tokens = m_tokens;
+    tokens.reset();
     if(!tokens.reserve(length / 2U)) {
         return ParserResult::fromError(Error::MEMORY);
     }
@@ -425,46 +833,46 @@ ParserResult Parser::parse(const char *const data, const unsigned length) noexce
         return ParserResult::fromError(Error::MEMORY);
     }
 
+    const unsigned objectCount = arenaCount<Object::ContainerType>(counters.object_elements),
+                   arrayCount  = arenaCount<Array::ContainerType> (counters.array_elements),
+                   stringCount = arenaCount<String::ContainerType>(counters.chars);
+
     if(m_arenas != nullptr) {
-        const ArenaSizes arenaCounts = {
-            counters.object_elements,
-            counters.array_elements,
-            counters.chars,
-            0U       
-        };
+        const ArenaSizes arenaCounts = {objectCount, arrayCount, stringCount, 0U};
 
         if(!reserveArenas(arenaCounts)) {
             return ParserResult::fromError(Error::MEMORY);
         }
     } else {
-        Result<unsigned> result = Util::safeMult(
-            counters.object_elements,
-            unsigned(sizeof(Object::ContainerType))
-        );
-        if(!result.isSuccess()) {
-            return ParserResult::fromError(Error::TOO_LARGE);
+        const ArenaSizes arenaSizes = {
+            objectCount * unsigned(sizeof(Object::ContainerType)),
+            arrayCount  * unsigned(sizeof(Array::ContainerType)),
+            stringCount * unsigned(sizeof(String::ContainerType)),
+            0U
+        };
+        if(!initArenas(arenaSizes, Arena::INFINITE_NODES)) {
+            return ParserResult::fromError(Error::MEMORY);
         }
-        const unsigned objectSizes = result.getValue();
+    }
 
-        result = Util::safeMult(
-            counters.array_elements,
-            unsigned(sizeof(Array::ContainerType))
-        );
-        if(!result.isSuccess()) {
-            return ParserResult::fromError(Error::TOO_LARGE);
-        }
-        const unsigned arraySizes = result.getValue();
+    RootNode *const rootNode = newRootNode();
+    if(rootNode == nullptr) {
+        return ParserResult::fromError(Error::MEMORY);
+    }
 
-        result = Util::safeMult(
-            counters.chars,
-            unsigned(sizeof(String::ContainerType))
-        );
-        if(!result.isSuccess()) {
-            return ParserResult::fromError(Error::TOO_LARGE);
-        }
-        const unsigned stringSizes = result.getValue();
+    const Error error = parseToken(rootNode->json, tokens);
+    if(error != Error::NONE) {
+        return ParserResult::fromError(error);
+    }
+    
+    return ParserResult::fromRef(rootNode->json);
+}
 
-        const ArenaSizes arenaSizes = {objectSizes, arraySizes, stringSizes, 0U};
+ParserResult Parser::parseFused(const char *const data, const std::size_t length) noexcept {
+    //there are no counters to size the arenas with, start from a fraction of the input and let them grow
+    if(m_arenas == nullptr) {
+        const unsigned   estimate   = arenaCount<char>(length / 4U);
+        const ArenaSizes arenaSizes = {estimate, estimate, estimate, 0U};
         if(!initArenas(arenaSizes, Arena::INFINITE_NODES)) {
             return ParserResult::fromError(Error::MEMORY);
         }
@@ -475,11 +883,20 @@ ParserResult Parser::parse(const char *const data, const unsigned length) noexce
         return ParserResult::fromError(Error::MEMORY);
     }
 
+    LexerStream tokens(data, length);
     const Error error = parseToken(rootNode->json, tokens);
+
+    //the rest of the input is still lexed so errors are reported like in the tokenizing mode
+    if(tokens.hasError() || !tokens.drain()) {
+        return ParserResult::fromError(Error::TOKEN);
+    }
+    if(tokens.isUnbalanced()) {
+        return ParserResult::fromError(Error::MEMORY);
+    }
     if(error != Error::NONE) {
         return ParserResult::fromError(error);
     }
-    
+
     return ParserResult::fromRef(rootNode->json);
 }
 
@@ -498,7 +915,7 @@ ParserResult Parser::parseFile(const char *const path) noexcept {
         return ParserResult::fromError(Error::FILE);
     }
 
-    return parse(reinterpret_cast<const char*>(fileContents.getData()), fileContents.getLength());
+    return parseBuffer(reinterpret_cast<const char*>(fileContents.getData()), fileContents.getLength(), false);
 }
 
 bool Parser::allocateArenas() noexcept {
@@ -590,21 +1007,20 @@ bool Parser::initArenas(const ArenaSizes arenaSizes, const unsigned maxNodes) no
     return true;
 }
 
+//only reserves what the document needs so parsing many small documents without reset doesn't take a new node each time
 bool Parser::reserveArenas(const ArenaSizes arenaCounts) noexcept {
     assert(m_arenas != nullptr);
 
-    int i = 0;
-
-    if(!m_arenas->object.reserve<Object::ContainerType>(std::max(arenaCounts[i++], Arena::MINIMUM_CAPACITY))) {
+    if(arenaCounts[0] > 0U && !m_arenas->object.reserve<Object::ContainerType>(arenaCounts[0])) {
         return false;
     }
-    if(!m_arenas->array.reserve<Array::ContainerType>(std::max(arenaCounts[i++], Arena::MINIMUM_CAPACITY))) {
+    if(arenaCounts[1] > 0U && !m_arenas->array.reserve<Array::ContainerType>(arenaCounts[1])) {
         return false;
     }
-    if(!m_arenas->string.reserve<String::ContainerType>(std::max(arenaCounts[i++], Arena::MINIMUM_CAPACITY))) {
+    if(arenaCounts[2] > 0U && !m_arenas->string.reserve<String::ContainerType>(arenaCounts[2])) {
         return false;
     }
-    if(!m_arenas->root.reserve<RootNode>(std::max(arenaCounts[i++], Arena::MINIMUM_CAPACITY))) {
+    if(arenaCounts[3] > 0U && !m_arenas->root.reserve<RootNode>(arenaCounts[3])) {
         return false;
     }
 
@@ -1,7 +1,15 @@
 #pragma once
 
 #include <array>
+#include <cassert>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 #include "error.hpp"
 #include "tokens.hpp"
@@ -12,12 +20,46 @@
 #include "string.hpp"
 #include "counters.hpp"
 #include "result.hpp"
+#include "lexer.hpp"
+#include "token.hpp"
 
 namespace CPPJSON {
 
 typedef Result<JSON&, Error> ParserResult;
 
+class LazyValue;
+class Binder;
+
 class Parser {
+    //decodes string and number tokens on demand
+    friend class LazyValue;
+    //reads values into C++ types for parseInto
+    friend class Binder;
+
+public:
+    struct Options {
+        //lex tokens while parsing instead of tokenizing the whole input first, the token array is never built
+        //but containers can't be pre-sized and grow as elements are added
+        bool fused = false;
+        //escape-free string values point into the parsed buffer instead of being copied to the string arena,
+        //the buffer must outlive the JSON. Ignored by parseFile since the file contents are freed after parsing
+        bool borrowStrings = false;
+        //maximum nesting of arrays and objects, deeper documents fail with Error::DEPTH. 0 means no limit
+        unsigned maxDepth = 0U;
+    };
+
+    //result of parsing newline delimited JSON
+    struct LinesResult {
+        Error         error   = Error::NONE;
+        //the number of records parsed, the index of the record that failed on errors
+        std::size_t   records = 0U;
+        //the byte offset of the record that failed
+        std::uint64_t offset  = 0U;
+    };
+
+    typedef std::function<void(JSON&)> LineCallback;
+
+private:
     struct Arenas {
         Arena object;
         Arena array;
@@ -42,33 +84,127 @@ class Parser {
 
     RootNode *newRootNode() noexcept;
     
-    bool decodeStringToken(String&, Token&) noexcept;
-    Error parseToken      (JSON&, Tokens&)  noexcept;
-    Error parseString     (JSON&, Tokens&)  noexcept;
-    Error parseArray      (JSON&, Tokens&)  noexcept;
-    Error parseObject     (JSON&, Tokens&)  noexcept;
-    Error parseNumber     (JSON&, Tokens&)  noexcept;
-    void parseNull        (JSON&, Tokens&)  noexcept;
-    void parseBool        (JSON&, Tokens&)  noexcept;
-
-    RootNode *m_firstRoot   = nullptr;
-    RootNode *m_currentRoot = nullptr;
-    ArenasPtr m_arenas      = {nullptr, deallocateArenas};
+    //how string tokens become Strings during the current parse
+    enum class StringMode {
+        COPY,
+        BORROW,
+        IN_SITU
+    };
+
+    template<typename TString>
+    static bool        decodeStringToken(TString&, const char *value, unsigned length)                noexcept;
+    static bool        decodeStringToken(std::string&, const char *value, unsigned length)           noexcept;
+    static std::size_t stringLength     (const char *value, const Token&)                             noexcept;
+    static Error       decodeNumber     (JSON&, const char *value, const Token&)                      noexcept;
+    Error              decodeString     (String&, const char *value, std::size_t length, bool isKey) noexcept;
+    
+    //builds the JSON of parseToken
+    class DomBuilder;
+    //passes the values to the handler of parse(data, length, handler)
+    template<typename THandler> class EventBuilder;
+
+    //parseValue is the only state machine of the grammar, the builder receives the values (string, number,
+    //boolean, null, open, close, element, decodeKey and key) and the other steps check the tokens around them.
+    //Binder reads typed values with the same steps. TTokens is either Tokens or LexerStream.
+    //depth is the number of containers around the value, only parseInto parses values that aren't at the root
+    template<typename TTokens, typename TBuilder> Error        parseValue   (TTokens&, TBuilder&, unsigned depth = 0U) noexcept;
+    template<typename TTokens>                    Error        openContainer(TTokens&, bool isArray, std::size_t depth, unsigned &length, bool &empty) noexcept;
+    template<typename TTokens, typename TBuilder> static Error nextElement  (TTokens&, TBuilder&)                      noexcept;
+    template<typename TTokens, typename TBuilder> static Error nextMember   (TTokens&, TBuilder&)                      noexcept;
+    template<typename TTokens>                    static Error afterValue   (TTokens&, bool isArray, bool &closed)     noexcept;
+    template<typename TTokens>                    Error        parseToken   (JSON&, TTokens&)                          noexcept;
+    bool pushContainer(JSON&) noexcept;
+    Error decodeEventString(const char *value, const Token&, const char *&str, unsigned &length) noexcept;
+
+    Parser      *lineParser        ()                                                                          noexcept;
+    Error        parseLine         (const char*, std::size_t length, const LineCallback&, std::size_t &records) noexcept;
+    ParserResult parseParallelArray(const char*, std::size_t length, unsigned threads, bool borrowStrings)      noexcept;
+    ParserResult parseBuffer(const char*, std::size_t length, bool borrowStrings) noexcept;
+    ParserResult parseTokens(const char*, std::size_t length)                     noexcept;
+    ParserResult parseFused (const char*, std::size_t length)                     noexcept;
+
+    typedef std::vector<JSON*, GeneralAllocator<JSON*>>             ContainerStack;
+    typedef std::vector<Token::Type, GeneralAllocator<Token::Type>> CloserStack;
+    typedef std::unique_ptr<Parser>                                 ParserPtr;
+    typedef std::vector<ParserPtr, GeneralAllocator<ParserPtr>>     Children;
+
+    RootNode      *m_firstRoot   = nullptr;
+    RootNode      *m_currentRoot = nullptr;
+    ArenasPtr      m_arenas      = {nullptr, deallocateArenas};
+    Options        m_options     = {};
+    StringMode     m_stringMode  = StringMode::COPY;
+    //the containers being built and the tokens, kept between parses to reuse their memory
+    ContainerStack m_stack{0, GeneralAllocator<JSON*>()};
+    Tokens         m_tokens;
+    //the closing token of each container being parsed by parseValue
+    CloserStack    m_closers{0, GeneralAllocator<Token::Type>()};
+    //escaped strings are decoded here before being passed to a handler
+    std::string    m_eventString;
+    //the parsers of the worker threads of parseParallel, they own the memory of the elements until reset
+    Children       m_children{0, GeneralAllocator<ParserPtr>()};
+    //parses the records of parseLines so the JSONs of this parser survive it, kept to reuse its memory
+    ParserPtr      m_lineParser;
     
 public:
     Parser()                         noexcept;
+    explicit Parser(const Options&)  noexcept;
     ~Parser()                        noexcept;
     Parser(const Parser&)                     = delete;
     Parser(Parser&&)                 noexcept = delete;
     Parser &operator=(const Parser&)          = delete;
     Parser &operator=(Parser&&)      noexcept = delete;
     
-    ParserResult init     ()                             noexcept;
-    ParserResult parse    (const std::string&)           noexcept;
-    ParserResult parse    (const char*)                  noexcept;
-    ParserResult parse    (const char*, unsigned length) noexcept;
-    ParserResult parseFile(const std::string&)           noexcept;
-    ParserResult parseFile(const char*)                  noexcept;
+    void           setOptions(const Options&) noexcept;
+    const Options &getOptions() const        noexcept;
+
+    ParserResult init        ()                                noexcept;
+    void         reset       ()                                noexcept;
+    ParserResult parse       (const std::string&)              noexcept;
+    ParserResult parse       (const char*)                     noexcept;
+    ParserResult parse       (const char*, std::size_t length) noexcept;
+    ParserResult parseInPlace(char*, std::size_t length)       noexcept;
+    ParserResult parseFile   (const std::string&)              noexcept;
+    ParserResult parseFile   (const char*)                     noexcept;
+
+    //parses the elements of a top level array on several threads (0 uses every core) and moves them in one Array.
+    //Other documents, small arrays and invalid ones are parsed on the calling thread, the result is the same as parse
+    ParserResult parseParallel    (const std::string&, unsigned threads = 0U)              noexcept;
+    ParserResult parseParallel    (const char*, std::size_t length, unsigned threads = 0U) noexcept;
+    ParserResult parseFileParallel(const std::string &path, unsigned threads = 0U)         noexcept;
+    ParserResult parseFileParallel(const char *path, unsigned threads = 0U)                noexcept;
+
+    //parses one JSON per line and passes each of them to the callback, stops at the first invalid record.
+    //The records are parsed by a parser of their own that is reset after every record so memory only depends on
+    //the largest one, only the JSON passed to the callback is destroyed when it returns. Blank lines are skipped.
+    //With more than 1 thread (0 uses every core) the records are parsed by worker threads with their own parsers
+    //but the callback is still called on the calling thread, in input order. The threaded path is experimental,
+    //its scaling hasn't been measured on several cores and it is slower than 1 thread on a single core.
+    LinesResult parseLines    (const std::string&, const LineCallback&, unsigned threads = 1U)              noexcept;
+    LinesResult parseLines    (const char*, std::size_t length, const LineCallback&, unsigned threads = 1U) noexcept;
+    //the file is read in chunks, it can be larger than the memory
+    LinesResult parseLinesFile(const std::string &path, const LineCallback&, unsigned threads = 1U)         noexcept;
+    LinesResult parseLinesFile(const char *path, const LineCallback&, unsigned threads = 1U)                noexcept;
+
+    //calls the methods of handler for every value instead of building a JSON:
+    //startObject(), endObject(), startArray(), endArray(), key(const char*, unsigned length),
+    //string(const char*, unsigned length), int64(std::int64_t), uint64(std::uint64_t), float64(double),
+    //boolean(bool) and null().
+    //Strings are only valid during the call and aren't null terminated. The events before an error are still sent.
+    //THandler must be a class so parse(data, length) with an integer variable isn't taken for a handler
+    template<typename THandler>
+    Error parse(const std::string&, THandler&, typename std::enable_if<std::is_class<THandler>::value>::type* = nullptr)              noexcept;
+    template<typename THandler>
+    Error parse(const char*, THandler&, typename std::enable_if<std::is_class<THandler>::value>::type* = nullptr)                     noexcept;
+    template<typename THandler>
+    Error parse(const char*, std::size_t length, THandler&, typename std::enable_if<std::is_class<THandler>::value>::type* = nullptr) noexcept;
+
+    //reads the document straight into value without building a JSON, T is a struct bound with CPPJSON_BIND,
+    //bool, an arithmetic type, std::string or a std::vector of those. Defined in bind.hpp.
+    //Members missing from the document and null values leave value unchanged, unknown keys are skipped.
+    //A value of the wrong type or out of the range of an integer fails with Error::TYPE.
+    template<typename T> Error parseInto(const std::string&, T &value)              noexcept;
+    template<typename T> Error parseInto(const char*, T &value)                     noexcept;
+    template<typename T> Error parseInto(const char*, std::size_t length, T &value) noexcept;
 
     Object::Allocator getObjectAllocator() noexcept;
     Array::Allocator  getArrayAllocator()  noexcept;
@@ -78,4 +214,312 @@ public:
     String createString(const char *);
 };
 
+template<typename THandler>
+Error Parser::parse(const std::string &data, THandler &handler, typename std::enable_if<std::is_class<THandler>::value>::type*) noexcept {
+    assert(data[0] != '\0');
+
+    return parse(data.c_str(), data.size(), handler);
+}
+
+template<typename THandler>
+Error Parser::parse(const char *const data, THandler &handler, typename std::enable_if<std::is_class<THandler>::value>::type*) noexcept {
+    assert(data != nullptr);
+    assert(data[0] != '\0');
+
+    return parse(data, std::strlen(data), handler);
+}
+
+template<typename THandler>
+Error Parser::parse(const char *const data, const std::size_t length, THandler &handler, typename std::enable_if<std::is_class<THandler>::value>::type*) noexcept {
+    assert(data != nullptr);
+    assert(length > 0);
+
+    LexerStream            tokens(data, length);
+    EventBuilder<THandler> builder(*this, handler);
+    const Error error = parseValue(tokens, builder);
+
+    //the rest of the input is still lexed so errors are reported like in the other modes
+    if(tokens.hasError() || !tokens.drain()) {
+        return Error::TOKEN;
+    }
+    if(tokens.isUnbalanced()) {
+        return Error::MEMORY;
+    }
+
+    return error;
+}
+
+template<typename THandler>
+class Parser::EventBuilder {
+    Parser     &m_parser;
+    THandler   &m_handler;
+    //the key is only passed once its colon is read
+    const char *m_key       = nullptr;
+    unsigned    m_keyLength = 0U;
+
+public:
+    EventBuilder(Parser &owner, THandler &handler) noexcept :
+        m_parser(owner),
+        m_handler(handler)
+    {}
+
+    Error string(const char *const value, const Token &token) noexcept {
+        const char *str;
+        unsigned    length;
+        const Error error = m_parser.decodeEventString(value, token, str, length);
+        if(error == Error::NONE) {
+            m_handler.string(str, length);
+        }
+        return error;
+    }
+
+    Error number(const char *const value, const Token &token) noexcept {
+        JSON json;
+        const Error error = decodeNumber(json, value, token);
+        if(error != Error::NONE) {
+            return error;
+        }
+
+        switch(json.getType()) {
+        case JSON::Type::INT64:
+            m_handler.int64(json.unsafeAsInt64());
+            break;
+        case JSON::Type::UINT64:
+            m_handler.uint64(json.unsafeAsUint64());
+            break;
+        default:
+            m_handler.float64(json.unsafeAsFloat64());
+        }
+        return Error::NONE;
+    }
+
+    void boolean(const bool value) noexcept {
+        m_handler.boolean(value);
+    }
+
+    void null() noexcept {
+        m_handler.null();
+    }
+
+    Error open(const bool isArray, unsigned) noexcept {
+        if(isArray) {
+            m_handler.startArray();
+        } else {
+            m_handler.startObject();
+        }
+        return Error::NONE;
+    }
+
+    void close(const bool isArray) noexcept {
+        if(isArray) {
+            m_handler.endArray();
+        } else {
+            m_handler.endObject();
+        }
+    }
+
+    void element() noexcept {}
+
+    Error decodeKey(const char *const value, const Token &token) noexcept {
+        return m_parser.decodeEventString(value, token, m_key, m_keyLength);
+    }
+
+    void key() noexcept {
+        m_handler.key(m_key, m_keyLength);
+    }
+};
+
+template<typename TTokens, typename TBuilder>
+Error Parser::parseValue(TTokens &tokens, TBuilder &builder, const unsigned depth) noexcept {
+    m_closers.clear();
+
+    for(;;) {
+        Error error = Error::NONE;
+
+        const Token &token = tokens.current();
+        switch(token.getType()) {
+        case Token::Type::STRING:
+            error = builder.string(tokens.value(token), token);
+            if(error != Error::NONE) {
+                return error;
+            }
+            tokens.advance();
+            break;
+
+        case Token::Type::INT:
+        case Token::Type::FLOAT:
+        case Token::Type::SCIENTIFIC_INT:
+            error = builder.number(tokens.value(token), token);
+            if(error != Error::NONE) {
+                return error;
+            }
+            tokens.advance();
+            break;
+
+        case Token::Type::BOOL:
+            builder.boolean(tokens.value(token)[0] == 't');
+            tokens.advance();
+            break;
+
+        case Token::Type::NUL:
+            builder.null();
+            tokens.advance();
+            break;
+
+        case Token::Type::LBRACKET:
+        case Token::Type::LCURLY: {
+            const bool isArray = token.getType() == Token::Type::LBRACKET;
+            unsigned   length;
+            bool       empty;
+            error = openContainer(tokens, isArray, m_closers.size() + depth, length, empty);
+            if(error == Error::NONE) {
+                error = builder.open(isArray, length);
+            }
+            if(error != Error::NONE) {
+                return error;
+            }
+            if(empty) {
+                builder.close(isArray);
+                break;
+            }
+
+            try {
+                m_closers.push_back(isArray ? Token::Type::RBRACKET : Token::Type::RCURLY);
+            } catch(...) {
+                return Error::MEMORY;
+            }
+
+            error = isArray ? nextElement(tokens, builder) : nextMember(tokens, builder);
+            if(error != Error::NONE) {
+                return error;
+            }
+            continue;
+        }
+
+        case Token::Type::COLON:
+        case Token::Type::COMMA:
+        case Token::Type::RBRACKET:
+        case Token::Type::RCURLY:
+        case Token::Type::INVALID:
+        case Token::Type::DONE:
+        default:
+            if(m_closers.empty()) {
+                return Error::TOKEN;
+            }
+            return m_closers.back() == Token::Type::RBRACKET ? Error::ARRAY_VALUE : Error::OBJECT_VALUE;
+        }
+
+        //the value is complete, close containers until one has another value
+        for(;;) {
+            if(m_closers.empty()) {
+                return Error::NONE;
+            }
+
+            const bool isArray = m_closers.back() == Token::Type::RBRACKET;
+            bool       closed;
+            error = afterValue(tokens, isArray, closed);
+            if(error != Error::NONE) {
+                return error;
+            }
+
+            if(!closed) {
+                error = isArray ? nextElement(tokens, builder) : nextMember(tokens, builder);
+                if(error != Error::NONE) {
+                    return error;
+                }
+                break;
+            }
+
+            m_closers.pop_back();
+            builder.close(isArray);
+        }
+    }
+}
+
+//the opening bracket is the current token, depth is the number of containers around it.
+//length is the length of the opening token, empty is true if the closing bracket follows, it is then read too
+template<typename TTokens>
+Error Parser::openContainer(TTokens &tokens, const bool isArray, const std::size_t depth, unsigned &length, bool &empty) noexcept {
+    if(m_options.maxDepth != 0U && depth >= std::size_t(m_options.maxDepth)) {
+        return Error::DEPTH;
+    }
+
+    length = tokens.current().getLength();
+
+    tokens.advance();
+    if(!tokens.hasTokens(1U)) {
+        return isArray ? Error::ARRAY : Error::OBJECT;
+    }
+
+    empty = tokens.current().getType() == (isArray ? Token::Type::RBRACKET : Token::Type::RCURLY);
+    if(empty) {
+        tokens.advance();
+    }
+
+    return Error::NONE;
+}
+
+//before every element of an array
+template<typename TTokens, typename TBuilder>
+Error Parser::nextElement(TTokens &tokens, TBuilder &builder) noexcept {
+    //a value followed by a comma or a right bracket
+    if(!tokens.hasTokens(2U)) {
+        return Error::ARRAY;
+    }
+
+    builder.element();
+    return Error::NONE;
+}
+
+//reads the key and the colon of the next member of an object
+template<typename TTokens, typename TBuilder>
+Error Parser::nextMember(TTokens &tokens, TBuilder &builder) noexcept {
+    //a key, a colon, a value and a comma or a right curly bracket
+    if(!tokens.hasTokens(4U)) {
+        return Error::OBJECT;
+    }
+
+    if(tokens.current().getType() != Token::Type::STRING) {
+        return Error::OBJECT_KEY;
+    }
+
+    const Error keyError = builder.decodeKey(tokens.value(tokens.current()), tokens.current());
+    if(keyError == Error::STRING) {
+        return Error::OBJECT_KEY;
+    }
+    if(keyError != Error::NONE) {
+        return keyError;
+    }
+
+    tokens.advance();
+
+    if(tokens.current().getType() != Token::Type::COLON) {
+        return Error::MISSING_COLON;
+    }
+
+    tokens.advance();
+    builder.key();
+
+    return Error::NONE;
+}
+
+//after a value of a container, closed is true once its closing bracket is read
+template<typename TTokens>
+Error Parser::afterValue(TTokens &tokens, const bool isArray, bool &closed) noexcept {
+    const Token::Type type = tokens.current().getType();
+    if(type == (isArray ? Token::Type::RBRACKET : Token::Type::RCURLY)) {
+        tokens.advance();
+        closed = true;
+        return Error::NONE;
+    }
+
+    if(type != Token::Type::COMMA) {
+        return isArray ? Error::MISSING_COMMA_OR_RBRACKET : Error::MISSING_COMMA_OR_RCURLY;
+    }
+
+    tokens.advance();
+    closed = false;
+    return Error::NONE;
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include "simd.hpp"
+
+#if defined(CPPJSON_SIMD_AVX2)
+    #include <immintrin.h>
+#elif defined(CPPJSON_SIMD_SSE2)
+    #include <emmintrin.h>
+#endif
+
+namespace CPPJSON {
+namespace Simd {
+
+static bool isControlChar(const char c) noexcept {
+    return static_cast<unsigned char>(c) <= 0x1FU;
+}
+
+#if defined(CPPJSON_SIMD_AVX2)
+
+static std::uint64_t movemask(const __m256i vector) noexcept {
+    return std::uint64_t(std::uint32_t(_mm256_movemask_epi8(vector)));
+}
+
+BlockMasks classify(const char *const block) noexcept {
+    const __m256i quote     = _mm256_set1_epi8('"'),
+                  backslash = _mm256_set1_epi8('\\'),
+                  lcurly    = _mm256_set1_epi8('{'),
+                  rcurly    = _mm256_set1_epi8('}'),
+                  colon     = _mm256_set1_epi8(':'),
+                  comma     = _mm256_set1_epi8(','),
+                  lowercase = _mm256_set1_epi8(0x20),
+                  space     = _mm256_set1_epi8(' '),
+                  tab       = _mm256_set1_epi8('\t'),
+                  newline   = _mm256_set1_epi8('\n'),
+                  carriage  = _mm256_set1_epi8('\r');
+
+    BlockMasks masks;
+    for(unsigned i = 0U; i < BLOCK_SIZE; i += 32U) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+        //'[' | 0x20 == '{' and ']' | 0x20 == '}', no other byte maps to them
+        const __m256i folded = _mm256_or_si256(chunk, lowercase);
+
+        const __m256i structural = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(folded, lcurly), _mm256_cmpeq_epi8(folded, rcurly)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, colon),   _mm256_cmpeq_epi8(chunk, comma))
+        );
+        const __m256i whitespace = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space),   _mm256_cmpeq_epi8(chunk, tab)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, newline), _mm256_cmpeq_epi8(chunk, carriage))
+        );
+
+        masks.structural |= movemask(structural)                           << i;
+        masks.whitespace |= movemask(whitespace)                           << i;
+        masks.quote      |= movemask(_mm256_cmpeq_epi8(chunk, quote))     << i;
+        masks.backslash  |= movemask(_mm256_cmpeq_epi8(chunk, backslash)) << i;
+    }
+
+    return masks;
+}
+
+std::size_t findQuoteOrBackslash(const char *const data, const std::size_t length) noexcept {
+    const __m256i quote     = _mm256_set1_epi8('"'),
+                  backslash = _mm256_set1_epi8('\\');
+
+    std::size_t i = 0U;
+    for(; length - i >= 32U; i += 32U) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const std::uint64_t mask = movemask(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)));
+        if(mask != 0U) {
+            return i + trailingZeros(mask);
+        }
+    }
+
+    for(; i < length && data[i] != '"' && data[i] != '\\'; i++);
+    return i;
+}
+
+std::size_t findBackslashOrControlChar(const char *const data, const std::size_t length) noexcept {
+    const __m256i backslash = _mm256_set1_epi8('\\'),
+                  control   = _mm256_set1_epi8(0x1F);
+
+    std::size_t i = 0U;
+    for(; length - i >= 32U; i += 32U) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        //min(c, 0x1F) == c only for bytes <= 0x1F
+        const __m256i isControl = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control), chunk);
+        const std::uint64_t mask = movemask(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, backslash), isControl));
+        if(mask != 0U) {
+            return i + trailingZeros(mask);
+        }
+    }
+
+    for(; i < length && data[i] != '\\' && !isControlChar(data[i]); i++);
+    return i;
+}
+
+std::size_t findEscapedChar(const char *const data, const std::size_t length) noexcept {
+    const __m256i quote     = _mm256_set1_epi8('"'),
+                  backslash = _mm256_set1_epi8('\\'),
+                  control   = _mm256_set1_epi8(0x1F);
+
+    std::size_t i = 0U;
+    for(; length - i >= 32U; i += 32U) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i isControl = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control), chunk);
+        const std::uint64_t mask = movemask(_mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+            isControl
+        ));
+        if(mask != 0U) {
+            return i + trailingZeros(mask);
+        }
+    }
+
+    for(; i < length && data[i] != '"' && data[i] != '\\' && !isControlChar(data[i]); i++);
+    return i;
+}
+
+#elif defined(CPPJSON_SIMD_SSE2)
+
+static std::uint64_t movemask(const __m128i vector) noexcept {
+    return std::uint64_t(unsigned(_mm_movemask_epi8(vector)));
+}
+
+BlockMasks classify(const char *const block) noexcept {
+    const __m128i quote     = _mm_set1_epi8('"'),
+                  backslash = _mm_set1_epi8('\\'),
+                  lcurly    = _mm_set1_epi8('{'),
+                  rcurly    = _mm_set1_epi8('}'),
+                  colon     = _mm_set1_epi8(':'),
+                  comma     = _mm_set1_epi8(','),
+                  lowercase = _mm_set1_epi8(0x20),
+                  space     = _mm_set1_epi8(' '),
+                  tab       = _mm_set1_epi8('\t'),
+                  newline   = _mm_set1_epi8('\n'),
+                  carriage  = _mm_set1_epi8('\r');
+
+    BlockMasks masks;
+    for(unsigned i = 0U; i < BLOCK_SIZE; i += 16U) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+        //'[' | 0x20 == '{' and ']' | 0x20 == '}', no other byte maps to them
+        const __m128i folded = _mm_or_si128(chunk, lowercase);
+
+        const __m128i structural = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(folded, lcurly), _mm_cmpeq_epi8(folded, rcurly)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, colon),   _mm_cmpeq_epi8(chunk, comma))
+        );
+        const __m128i whitespace = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, space),   _mm_cmpeq_epi8(chunk, tab)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, newline), _mm_cmpeq_epi8(chunk, carriage))
+        );
+
+        masks.structural |= movemask(structural)                        << i;
+        masks.whitespace |= movemask(whitespace)                        << i;
+        masks.quote      |= movemask(_mm_cmpeq_epi8(chunk, quote))     << i;
+        masks.backslash  |= movemask(_mm_cmpeq_epi8(chunk, backslash)) << i;
+    }
+
+    return masks;
+}
+
+std::size_t findQuoteOrBackslash(const char *const data, const std::size_t length) noexcept {
+    const __m128i quote     = _mm_set1_epi8('"'),
+                  backslash = _mm_set1_epi8('\\');
+
+    std::size_t i = 0U;
+    for(; length - i >= 16U; i += 16U) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const std::uint64_t mask = movemask(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+        if(mask != 0U) {
+            return i + trailingZeros(mask);
+        }
+    }
+
+    for(; i < length && data[i] != '"' && data[i] != '\\'; i++);
+    return i;
+}
+
+std::size_t findBackslashOrControlChar(const char *const data, const std::size_t length) noexcept {
+    const __m128i backslash = _mm_set1_epi8('\\'),
+                  control   = _mm_set1_epi8(0x1F);
+
+    std::size_t i = 0U;
+    for(; length - i >= 16U; i += 16U) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        //min(c, 0x1F) == c only for bytes <= 0x1F
+        const __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk);
+        const std::uint64_t mask = movemask(_mm_or_si128(_mm_cmpeq_epi8(chunk, backslash), isControl));
+        if(mask != 0U) {
+            return i + trailingZeros(mask);
+        }
+    }
+
+    for(; i < length && data[i] != '\\' && !isControlChar(data[i]); i++);
+    return i;
+}
+
+std::size_t findEscapedChar(const char *const data, const std::size_t length) noexcept {
+    const __m128i quote     = _mm_set1_epi8('"'),
+                  backslash = _mm_set1_epi8('\\'),
+                  control   = _mm_set1_epi8(0x1F);
+
+    std::size_t i = 0U;
+    for(; length - i >= 16U; i += 16U) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk);
+        const std::uint64_t mask = movemask(_mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+            isControl
+        ));
+        if(mask != 0U) {
+            return i + trailingZeros(mask);
+        }
+    }
+
+    for(; i < length && data[i] != '"' && data[i] != '\\' && !isControlChar(data[i]); i++);
+    return i;
+}
+
+#else
+
+BlockMasks classify(const char *const block) noexcept {
+    BlockMasks masks;
+    for(unsigned i = 0U; i < BLOCK_SIZE; i++) {
+        const std::uint64_t bit = std::uint64_t(1U) << i;
+
+        switch(block[i]) {
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+            masks.structural |= bit;
+            break;
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+            masks.whitespace |= bit;
+            break;
+        case '"':
+            masks.quote |= bit;
+            break;
+        case '\\':
+            masks.backslash |= bit;
+            break;
+        default:;
+        }
+    }
+
+    return masks;
+}
+
+std::size_t findQuoteOrBackslash(const char *const data, const std::size_t length) noexcept {
+    std::size_t i = 0U;
+    for(; i < length && data[i] != '"' && data[i] != '\\'; i++);
+    return i;
+}
+
+std::size_t findBackslashOrControlChar(const char *const data, const std::size_t length) noexcept {
+    std::size_t i = 0U;
+    for(; i < length && data[i] != '\\' && !isControlChar(data[i]); i++);
+    return i;
+}
+
+std::size_t findEscapedChar(const char *const data, const std::size_t length) noexcept {
+    std::size_t i = 0U;
+    for(; i < length && data[i] != '"' && data[i] != '\\' && !isControlChar(data[i]); i++);
+    return i;
+}
+
+#endif
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(CPPJSON_NO_SIMD) && defined(__AVX2__)
+    #define CPPJSON_SIMD_AVX2
+#elif !defined(CPPJSON_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define CPPJSON_SIMD_SSE2
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+namespace CPPJSON {
+namespace Simd {
+
+static const unsigned BLOCK_SIZE = 64U;
+
+//one bit per byte of a 64 bytes block, bit 0 is the first byte
+struct BlockMasks {
+    std::uint64_t structural = 0U, //{}[]:,
+                  whitespace = 0U, //space, \t, \n, \r
+                  quote      = 0U,
+                  backslash  = 0U;
+};
+
+BlockMasks classify(const char *block) noexcept;
+
+//offset of the first '"' or '\\' in data, length if there are none
+std::size_t findQuoteOrBackslash(const char *data, std::size_t length) noexcept;
+
+//offset of the first '\\' or control character (0x00 to 0x1F) in data, length if there are none
+std::size_t findBackslashOrControlChar(const char *data, std::size_t length) noexcept;
+
+//offset of the first character that has to be escaped in a JSON string ('"', '\\' or 0x00 to 0x1F), length if there are none
+std::size_t findEscapedChar(const char *data, std::size_t length) noexcept;
+
+//index of the lowest set bit, bits must not be 0
+template<typename T>
+unsigned trailingZeros(const T bits) noexcept {
+    assert(bits != 0U);
+
+#if defined(__GNUC__) || defined(__clang__)
+    return unsigned(__builtin_ctzll(static_cast<unsigned long long>(bits)));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, static_cast<unsigned __int64>(bits));
+    return unsigned(index);
+#else
+    unsigned count = 0U;
+    for(T bit = 1U; (bits & bit) == 0U; bit <<= 1U) {
+        count++;
+    }
+    return count;
+#endif
+}
+
+}
+}
\ No newline at end of file
@@ -16,17 +16,21 @@ m_data(std::move(allocator))
 {}
 
 String::String(const String &string) :
-m_data(string.m_data)
+m_data(string.m_data),
+m_borrowed(string.m_borrowed),
+m_borrowedLength(string.m_borrowedLength),
+m_borrowedTerminated(string.m_borrowedTerminated)
 {}
 
 String::~String() noexcept {}
 
 String::ValueType &String::operator[](const unsigned index) noexcept {
+    assert(m_borrowed == nullptr);
     return m_data[index];
 }
 
 const String::ValueType &String::operator[](const unsigned index) const noexcept {
-    return m_data[index];
+    return data()[index];
 }
 
 const String &String::operator+=(const std::string &str) {
@@ -38,34 +42,50 @@ const String &String::operator=(const std::string &str) {
 }
 
 bool String::operator==(const std::string &str) const {
-    return operator==(str.c_str());
+    return size() == str.size() && std::memcmp(data(), str.data(), str.size()) == 0;
 }
 
 const String &String::operator+=(const String &str) {
-    return operator+=(str.getCString());
+    append(str.data(), str.size());
+
+    return *this;
 }
 
 String &String::operator=(const String &str) {
-    operator=(str.getCString());
+    if(this == &str) {
+        return *this;
+    }
+
+    if(str.m_borrowed != nullptr) {
+        m_data.clear();
+        borrow(str.m_borrowed, str.m_borrowedLength, str.m_borrowedTerminated);
+    } else {
+        m_borrowed = nullptr;
+        m_data.assign(str.m_data.data(), str.m_data.size());
+    }
 
     return *this;
 }
 
 String &String::operator=(String &&str) noexcept {
     if(this != &str) {
-        m_data = std::move(str.m_data);
+        m_data               = std::move(str.m_data);
+        m_borrowed           = str.m_borrowed;
+        m_borrowedLength     = str.m_borrowedLength;
+        m_borrowedTerminated = str.m_borrowedTerminated;
     }
 
     return *this;
 }
 
 bool String::operator==(const String &str) const {
-    return this == &str || (*this)==(str.getCString());
+    return this == &str || (size() == str.size() && std::memcmp(data(), str.data(), std::size_t(size())) == 0);
 }
 
 const String &String::operator+=(const char *const str) {
     assert(str != nullptr);
 
+    copyBorrowed();
     m_data += str;
 
     return *this;
@@ -74,7 +94,8 @@ const String &String::operator+=(const char *const str) {
 const String &String::operator=(const char *const str) {
     assert(str != nullptr);
 
-    m_data = str;
+    m_borrowed = nullptr;
+    m_data     = str;
 
     return *this;
 }
@@ -82,11 +103,12 @@ const String &String::operator=(const char *const str) {
 bool String::operator==(const char *const str) const {
     assert(str != nullptr);
 
-    return std::strcmp(m_data.c_str(), str) == 0;
+    const std::size_t length = std::strlen(str);
+    return length == std::size_t(size()) && std::memcmp(data(), str, length) == 0;
 }
 
 unsigned String::size() const noexcept {
-    return unsigned(m_data.size());
+    return m_borrowed != nullptr ? m_borrowedLength : unsigned(m_data.size());
 }
 
 bool String::reserve(unsigned capacity) {
@@ -95,6 +117,7 @@ bool String::reserve(unsigned capacity) {
     }
 
     try {
+        copyBorrowed();
         m_data.reserve(std::size_t(capacity));
     } catch (...) {
         return false;
@@ -104,20 +127,71 @@ bool String::reserve(unsigned capacity) {
 }
 
 void String::push(const ValueType value) {
+    copyBorrowed();
     m_data.push_back(value);
 }
 
+void String::append(const char *const str, const unsigned length) {
+    assert(str != nullptr);
+
+    copyBorrowed();
+    m_data.append(str, std::size_t(length));
+}
+
+void String::borrow(const char *const str, const unsigned length, const bool nullTerminated) noexcept {
+    assert(str != nullptr);
+    assert(!nullTerminated || str[length] == '\0');
+
+    m_borrowed           = str;
+    m_borrowedLength     = length;
+    m_borrowedTerminated = nullTerminated;
+}
+
+bool String::isBorrowed() const noexcept {
+    return m_borrowed != nullptr;
+}
+
+bool String::materialize() noexcept {
+    try {
+        copyBorrowed();
+    } catch(...) {
+        return false;
+    }
+
+    return true;
+}
+
+void String::copyBorrowed() {
+    if(m_borrowed == nullptr) {
+        return;
+    }
+
+    m_data.assign(m_borrowed, std::size_t(m_borrowedLength));
+    m_borrowed = nullptr;
+}
+
 unsigned String::toStringSize() const noexcept {
     return unsigned(static_strlen("\"")) + size() + unsigned(static_strlen("\""));
 }
 
 void String::toString(std::string &string) const noexcept {
     string.push_back('"');
-    string += getCString();
+    string.append(data(), std::size_t(size()));
     string.push_back('"');
 }
 
-const char *String::getCString() const noexcept { return m_data.c_str(); }
+const char *String::getCString() const noexcept { 
+    if(m_borrowed != nullptr) {
+        assert(m_borrowedTerminated);
+        return m_borrowed;
+    }
+
+    return m_data.c_str();
+}
+
+const char *String::data() const noexcept {
+    return m_borrowed != nullptr ? m_borrowed : m_data.data();
+}
 
 String::Allocator String::getAllocator() const noexcept { 
     return m_data.get_allocator();
@@ -128,11 +202,11 @@ void String::destructor() noexcept {
 }
 
 String::const_iterator String::begin() const noexcept {
-    return m_data.begin();
+    return data();
 }
 
 String::const_iterator String::end() const noexcept {
-    return m_data.end();
+    return data() + size();
 }
 
 }
\ No newline at end of file
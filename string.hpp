@@ -20,7 +20,7 @@ public:
         Allocator
     > Container;
 
-    typedef Container::const_iterator const_iterator;
+    typedef const ValueType *const_iterator;
 
     static const unsigned MINIMUM_CAPACITY; 
 
@@ -45,6 +45,12 @@ public:
     unsigned         size      ()                    const noexcept;
     bool             reserve   (unsigned);
     void             push      (ValueType);
+    void             append    (const char*, unsigned length);
+    void             borrow    (const char*, unsigned length, bool nullTerminated = false) noexcept;
+    bool             isBorrowed()                    const noexcept;
+    //copies a borrowed string so it can be written through operator[] or read with getCString,
+    //false if the copy can't be allocated
+    bool             materialize()                         noexcept;
 
     const String &operator+=(std::nullptr_t) = delete;
     const String &operator= (std::nullptr_t) = delete;
@@ -52,7 +58,9 @@ public:
     unsigned toStringSize()              const noexcept;
     void     toString    (std::string&) const noexcept;
 
+    //a borrowed string that isn't null terminated must be copied with materialize first
     const char       *getCString  () const noexcept;
+    const char       *data        () const noexcept;
     Allocator         getAllocator() const noexcept;   
 
     void destructor() noexcept;
@@ -61,7 +69,15 @@ public:
     const_iterator end()   const noexcept;
 
 private:
-    Container m_data;
+    //a borrowed string points into a buffer owned by the caller, it is only copied into m_data
+    //when it gets modified or materialized. The const functions never copy it so a const String
+    //can be read from several threads
+    Container   m_data;
+    const char *m_borrowed           = nullptr;
+    unsigned    m_borrowedLength     = 0U;
+    bool        m_borrowedTerminated = false;
+
+    void copyBorrowed();
 };
 
 }
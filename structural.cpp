@@ -0,0 +1,136 @@
+#include <cstring>
+
+#include "structural.hpp"
+
+namespace CPPJSON {
+
+StructuralScanner::StructuralScanner(const char *const data, const std::size_t length) noexcept :
+    m_data(data),
+    m_length(length)
+{}
+
+//bit i is set if an odd number of bits are set in [0, i]
+static std::uint64_t prefixXor(std::uint64_t bits) noexcept {
+    bits ^= bits << 1U;
+    bits ^= bits << 2U;
+    bits ^= bits << 4U;
+    bits ^= bits << 8U;
+    bits ^= bits << 16U;
+    bits ^= bits << 32U;
+    return bits;
+}
+
+//marks the characters escaped by an odd run of backslashes, runs can continue from the previous block
+std::uint64_t StructuralScanner::findEscaped(std::uint64_t backslash) noexcept {
+    static const std::uint64_t EVEN_BITS = 0x5555555555555555ULL;
+
+    backslash &= ~m_prevEscaped;
+    const std::uint64_t followsEscape     = (backslash << 1U) | m_prevEscaped;
+    const std::uint64_t oddSequenceStarts = backslash & ~EVEN_BITS & ~followsEscape;
+
+    //adding the start of each run to the run carries past its end, the carry lands on the escaped character
+    const std::uint64_t sequencesStartingOnEvenBits = oddSequenceStarts + backslash;
+    m_prevEscaped = sequencesStartingOnEvenBits < oddSequenceStarts ? 1U : 0U;
+
+    const std::uint64_t invertMask = sequencesStartingOnEvenBits << 1U;
+    return (EVEN_BITS ^ invertMask) & followsEscape;
+}
+
+void StructuralScanner::scanBlock() noexcept {
+    const char *block = m_data + m_blockEnd;
+
+    //the last block is padded with whitespace
+    char     padded[Simd::BLOCK_SIZE];
+    unsigned blockSize = Simd::BLOCK_SIZE;
+    if(m_length - m_blockEnd < Simd::BLOCK_SIZE) {
+        blockSize = unsigned(m_length - m_blockEnd);
+        std::memset(padded, ' ', sizeof(padded));
+        std::memcpy(padded, block, std::size_t(blockSize));
+        block = padded;
+    }
+
+    const Simd::BlockMasks masks = Simd::classify(block);
+
+    const std::uint64_t quote  = masks.quote & ~findEscaped(masks.backslash);
+    //includes the opening quote but not the closing one
+    const std::uint64_t quoted = prefixXor(quote) ^ m_prevQuoted;
+    m_prevQuoted = std::uint64_t(0U) - (quoted >> 63U);
+
+    const std::uint64_t scalar         = ~(masks.structural | masks.whitespace);
+    const std::uint64_t nonQuoteScalar = scalar & ~quote;
+    const std::uint64_t scalarStart    = scalar & ~((nonQuoteScalar << 1U) | m_prevScalar);
+    m_prevScalar = nonQuoteScalar >> 63U;
+
+    const std::uint64_t stringTail = quoted ^ quote;
+
+    m_bits       = (masks.structural | scalarStart) & ~stringTail;
+    m_blockStart = m_blockEnd;
+    m_blockEnd  += blockSize;
+}
+
+
+bool StructuralScanner::splitArray(const char *const data, const std::size_t length, Spans &elements) noexcept {
+    StructuralScanner scanner(data, length);
+    std::size_t position;
+    if(!scanner.next(position) || data[position] != '[') {
+        return false;
+    }
+
+    //values counts the token starts at depth 1, every element must have exactly one
+    std::size_t depth  = 1U,
+                values = 0U,
+                start  = position + 1U;
+    try {
+        while(scanner.next(position)) {
+            switch(data[position]) {
+            case '[':
+            case '{':
+                if(depth == 1U) {
+                    values++;
+                }
+                depth++;
+                break;
+
+            case ']':
+            case '}':
+                if(--depth == 0U) {
+                    if(data[position] != ']' || values > 1U || (values == 0U && !elements.empty())) {
+                        return false;
+                    }
+                    //anything after the array is left to parseBuffer to report
+                    if(scanner.next(position)) {
+                        return false;
+                    }
+                    if(values == 1U) {
+                        elements.push_back({start, position - start});
+                    }
+                    return true;
+                }
+                break;
+
+            case ',':
+                if(depth == 1U) {
+                    if(values != 1U) {
+                        return false;
+                    }
+                    elements.push_back({start, position - start});
+                    start  = position + 1U;
+                    values = 0U;
+                }
+                break;
+
+            case ':':
+                break;
+
+            default:
+                if(depth == 1U) {
+                    values++;
+                }
+            }
+        }
+    } catch(...) {}
+
+    return false;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "simd.hpp"
+#include "allocator.hpp"
+
+namespace CPPJSON {
+
+//Stage 1 of the lexer: classifies the input 64 bytes at a time and yields the position of every token start
+//(structural characters, opening quotes and the first character of numbers/keywords/invalid tokens).
+//Positions inside strings are never yielded.
+class StructuralScanner {
+    const char   *m_data        = nullptr;
+    std::size_t   m_length      = 0U;
+    std::size_t   m_blockStart  = 0U,
+                  m_blockEnd    = 0U;
+    std::uint64_t m_bits        = 0U,
+                  m_prevEscaped = 0U,
+                  m_prevQuoted  = 0U,
+                  m_prevScalar  = 0U;
+
+    void          scanBlock  ()                         noexcept;
+    std::uint64_t findEscaped(std::uint64_t backslash) noexcept;
+
+public:
+    struct Span {
+        std::size_t start,
+                    length;
+    };
+    typedef std::vector<Span, GeneralAllocator<Span>> Spans;
+
+    StructuralScanner(const char *data, std::size_t length) noexcept;
+    StructuralScanner()                                     noexcept = delete;
+
+    bool next(std::size_t &position) noexcept {
+        while(m_bits == 0U) {
+            if(m_blockEnd >= m_length) {
+                return false;
+            }
+            scanBlock();
+        }
+
+        position = m_blockStart + Simd::trailingZeros(m_bits);
+        m_bits  &= m_bits - 1U;
+
+        return true;
+    }
+
+    //finds the elements of the array data starts with, false if data isn't an array or if its elements aren't
+    //single values separated by commas. The elements themselves aren't validated.
+    static bool splitArray(const char *data, std::size_t length, Spans &elements) noexcept;
+};
+
+}
\ No newline at end of file
@@ -1,7 +1,13 @@
 #include <string>
+#include <vector>
 #include <cassert>
 #include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <thread>
 
 #include "../cppjson.hpp"
 
@@ -594,6 +600,1004 @@ static void testCreateObject() {
     assert(object1[key3].unsafeAsInt64() == value3);
 }
 
+static void testMaxDepth() {
+    const auto nested = [](const unsigned depth) {
+        std::string data;
+        for(unsigned i = 0U; i < depth; i++) {
+            data += "[{\"a\":";
+        }
+        data += "1";
+        for(unsigned i = 0U; i < depth; i++) {
+            data += "}]";
+        }
+        return data;
+    };
+
+    //no recursion, only the limit stops deep documents
+    Parser parser;
+    assert(parser.parse(nested(10000U)).isSuccess());
+
+    Parser::Options options;
+    options.maxDepth = 10U;
+    parser.setOptions(options);
+    assert(parser.parse(nested(5U)).isSuccess());
+
+    const ParserResult parserResult = parser.parse(nested(6U));
+    assert(!parserResult.isSuccess());
+    assert(parserResult.getError() == Error::DEPTH);
+}
+
+static void testLongEscapedStrings() {
+    //escapes land on every offset of the 16/32 bytes chunks
+    for(unsigned length = 0U; length < 80U; length++) {
+        const std::string padding(length, 'a');
+        const std::string longString = "[\"" + padding + "\\\\\\\"" + padding + "\\\\\"]";
+
+        Parser parser;
+        const ParserResult parserResult = parser.parse(longString);
+        assert(parserResult.isSuccess());
+        const String &string = parserResult.getRef()[0U].unsafeAsString();
+        assert(string == padding + "\\\"" + padding + "\\");
+    }
+}
+
+static void testVeryDeepNesting() {
+    const unsigned depth = 200U;
+
+    std::string veryDeepNesting;
+    for(unsigned i = 0U; i < depth; i++) {
+        veryDeepNesting += "[0, ";
+    }
+    veryDeepNesting += "1";
+    for(unsigned i = 0U; i < depth; i++) {
+        veryDeepNesting += "]";
+    }
+
+    Parser parser;
+    const ParserResult parserResult = parser.parse(veryDeepNesting);
+    assert(parserResult.isSuccess());
+
+    const JSON *json = &parserResult.getRef();
+    for(unsigned i = 0U; i < depth; i++) {
+        assert(json->getType() == JSON::Type::ARRAY);
+        assert(json->asArray().getRef().size() == 2U);
+        json = &json->asArray().getRef().unsafeGet(1U);
+    }
+    assert(json->asUint64().getValue() == 1U);
+}
+
+static void testBorrowedStrings() {
+    Parser::Options options;
+    options.borrowStrings = true;
+
+    Parser parser(options);
+    const std::string data = "{\"key1\": \"value\", \"key2\": \"escaped\\nvalue\"}";
+    const ParserResult parserResult = parser.parse(data);
+    assert(parserResult.isSuccess());
+    JSON &json = parserResult.getRef();
+
+    String &value1 = json["key1"].unsafeAsString();
+    assert(value1.isBorrowed());
+    assert(value1.data() > data.c_str() && value1.data() < data.c_str() + data.size());
+    assert(value1.size() == 5U);
+    assert(value1 == "value");
+    assert(std::string(value1.begin(), value1.end()) == "value");
+
+    const String &value2 = json["key2"].unsafeAsString();
+    assert(!value2.isBorrowed());
+    assert(value2 == "escaped\nvalue");
+
+    //the view isn't null terminated, it has to be copied before getCString
+    String copy = value1;
+    assert(copy.isBorrowed());
+    assert(copy.materialize());
+    assert(std::strcmp(copy.getCString(), "value") == 0);
+    assert(!copy.isBorrowed() && value1.isBorrowed());
+
+    //modifying a borrowed string copies it first
+    value1 += "1";
+    assert(!value1.isBorrowed());
+    assert(value1 == "value1");
+    assert(data == "{\"key1\": \"value\", \"key2\": \"escaped\\nvalue\"}");
+    assert(json.toString() == "{\"key1\":\"value1\",\"key2\":\"escaped\nvalue\"}" || json.toString() == "{\"key2\":\"escaped\nvalue\",\"key1\":\"value1\"}");
+}
+
+static void testParseInPlace() {
+    char data[] = "{\"key\\u0031\": [\"plain\", \"tab\\there\", \"\\u00e9\\\"\"]}";
+
+    Parser parser;
+    const ParserResult parserResult = parser.parseInPlace(data, sizeof(data) - 1U);
+    assert(parserResult.isSuccess());
+    const JSON &json = parserResult.getRef();
+
+    const Array &array = json["key1"].unsafeAsArray();
+    assert(array.size() == 3U);
+    for(const JSON &value : array) {
+        //decoded strings live in the input buffer and are null terminated
+        const String &string = value.unsafeAsString();
+        assert(string.isBorrowed());
+        assert(string.getCString() >= data && string.getCString() < data + sizeof(data));
+        assert(string.getCString()[string.size()] == '\0');
+    }
+    assert(array[0U].unsafeAsString() == "plain");
+    assert(array[1U].unsafeAsString() == "tab\there");
+    assert(array[2U].unsafeAsString() == "\xC3\xA9\"");
+
+    char invalid[] = "[\"\\x\"]";
+    const ParserResult invalidResult = parser.parseInPlace(invalid, sizeof(invalid) - 1U);
+    assert(!invalidResult.isSuccess());
+    assert(invalidResult.getError() == Error::STRING);
+}
+
+static void testFused() {
+    Parser::Options options;
+    options.fused = true;
+
+    Parser parser(options);
+    const std::string data = "{\"key1\": [1, -2, 3.5, true, null, \"a\\nb\"], \"key2\": {\"key3\": {}}, \"key4\": []}";
+    const ParserResult parserResult = parser.parse(data);
+    assert(parserResult.isSuccess());
+    const JSON &json = parserResult.getRef();
+
+    assert(json["key1"][0U].asUint64().getValue() == 1U);
+    assert(json["key1"][1U].asInt64().getValue() == -2);
+    assert(json["key1"][2U].asFloat64().getValue() == 3.5);
+    assert(json["key1"][3U].asBool().getValue());
+    assert(json["key1"][4U].asNull().isSuccess());
+    assert(json["key1"][5U].asString().getRef() == "a\nb");
+    assert(json["key2"]["key3"].asObject().isSuccess());
+    assert(json["key4"].asArray().isSuccess());
+
+    //growing an array moves its elements, nested containers must survive
+    std::string grown = "[";
+    for(unsigned i = 0U; i < 100U; i++) {
+        grown += "{\"a\": {\"b\": [1, {\"c\": 2}]}},";
+    }
+    grown += "{}]";
+    Parser tokenizing;
+    assert(parser.parse(grown).getRef().toString() == tokenizing.parse(grown).getRef().toString());
+
+    //same errors as the tokenizing mode
+    const ParserResult missingValue = parser.parse("{\"key1\": \"value1\", \"key2\": }");
+    assert(!missingValue.isSuccess());
+    assert(missingValue.getError() == Error::OBJECT);
+
+    const ParserResult missingComma = parser.parse("[1 2]");
+    assert(!missingComma.isSuccess());
+    assert(missingComma.getError() == Error::MISSING_COMMA_OR_RBRACKET);
+
+    const ParserResult invalidToken = parser.parse("[1, 2] x");
+    assert(!invalidToken.isSuccess());
+    assert(invalidToken.getError() == Error::TOKEN);
+}
+
+static void testNumbers() {
+    Parser parser;
+    const std::string data = "[18446744073709551615, -9223372036854775808, 123456789012, 0.1, -0.0025, "
+                             "0.000000000000000000000000000001, 9007199254740993.0, 0.30000000000000004, "
+                             "3.14159265358979323846264338327950288]";
+    const ParserResult parserResult = parser.parse(data);
+    assert(parserResult.isSuccess());
+    const JSON &json = parserResult.getRef();
+
+    assert(json[0U].asUint64().getValue()  == std::numeric_limits<std::uint64_t>::max());
+    assert(json[1U].asInt64().getValue()   == std::numeric_limits<std::int64_t>::min());
+    assert(json[2U].asUint64().getValue()  == 123456789012U);
+    assert(json[3U].asFloat64().getValue() == 0.1);
+    assert(json[4U].asFloat64().getValue() == -0.0025);
+    assert(json[5U].asFloat64().getValue() == 1e-30);
+    assert(json[6U].asFloat64().getValue() == 9007199254740992.0);
+    assert(json[7U].asFloat64().getValue() == 0.1 + 0.2);
+    assert(json[8U].asFloat64().getValue() == 3.14159265358979323846);
+
+    const ParserResult uint64Overflow = parser.parse("18446744073709551616");
+    assert(!uint64Overflow.isSuccess());
+    assert(uint64Overflow.getError() == Error::UINT64);
+
+    const ParserResult int64Overflow = parser.parse("-9223372036854775809");
+    assert(!int64Overflow.isSuccess());
+    assert(int64Overflow.getError() == Error::INT64);
+
+    const ParserResult float64Overflow = parser.parse("1" + std::string(309U, '0') + ".0");
+    assert(!float64Overflow.isSuccess());
+    assert(float64Overflow.getError() == Error::FLOAT64);
+
+    //more than 19 significant digits, halfway points round to even unless a later digit isn't 0
+    //the first digits of half the smallest subnormal
+    const std::string minHalfway = "2.470328229206232720882843964341106861825299013071623822127928412503377536351043759326499181808179961";
+    const std::string longData   = "[9007199254740993.000000000000000000000, 9007199254740993." + std::string(400U, '0') + "1, "
+                                   "1111111111111111111111111111111111111111.5, 0." + std::string(400U, '0') + "15e401, " +
+                                   minHalfway + "8e-324, " + minHalfway + "9e-324]";
+    const ParserResult longResult = parser.parse(longData);
+    assert(longResult.isSuccess());
+    const JSON &longJSON = longResult.getRef();
+
+    assert(longJSON[0U].asFloat64().getValue() == 9007199254740992.0);
+    assert(longJSON[1U].asFloat64().getValue() == 9007199254740994.0);
+    assert(longJSON[2U].asFloat64().getValue() == 1111111111111111111111111111111111111111.5);
+    assert(longJSON[3U].asFloat64().getValue() == 1.5);
+    assert(longJSON[4U].asFloat64().getValue() == 0.0);
+    assert(longJSON[5U].asFloat64().getValue() == std::numeric_limits<double>::denorm_min());
+
+    //the first digits of the point halfway between the largest double and 2^1024
+    const std::string maxHalfway = "17976931348623158079372897140530341507993413271003782693617377898044496829276475";
+    const ParserResult longMax = parser.parse(maxHalfway + "0" + std::string(228U, '0') + ".0");
+    assert(longMax.isSuccess());
+    assert(longMax.getRef().asFloat64().getValue() == std::numeric_limits<double>::max());
+
+    const ParserResult longOverflow = parser.parse(maxHalfway + "1" + std::string(228U, '0') + ".0");
+    assert(!longOverflow.isSuccess());
+    assert(longOverflow.getError() == Error::FLOAT64);
+}
+
+static void testScientificIntegers() {
+    Parser parser;
+    const std::string data = "[1.7e12, -25E3, 9007199254740993e0, 1.8446744073709551615e19, -9.223372036854775808E+18, "
+                             "120e-1, 1.5e0, 1e-5, -2.5E-3]";
+    const ParserResult parserResult = parser.parse(data);
+    assert(parserResult.isSuccess());
+    const JSON &json = parserResult.getRef();
+
+    assert(json[0U].asUint64().getValue() == 1700000000000U);
+    assert(json[1U].asInt64().getValue()  == -25000);
+    assert(json[2U].asUint64().getValue() == 9007199254740993U);
+    assert(json[3U].asUint64().getValue() == std::numeric_limits<std::uint64_t>::max());
+    assert(json[4U].asInt64().getValue()  == std::numeric_limits<std::int64_t>::min());
+    assert(json[5U].asUint64().getValue() == 12U);
+
+    //not integral, parsed as doubles instead
+    assert(json[6U].asFloat64().getValue() == 1.5);
+    assert(json[7U].asFloat64().getValue() == 1e-5);
+    assert(json[8U].asFloat64().getValue() == -2.5e-3);
+
+    const ParserResult uint64Overflow = parser.parse("1.8446744073709551616e19");
+    assert(!uint64Overflow.isSuccess());
+    assert(uint64Overflow.getError() == Error::UINT64);
+
+    const ParserResult int64Overflow = parser.parse("-1e19");
+    assert(!int64Overflow.isSuccess());
+    assert(int64Overflow.getError() == Error::INT64);
+}
+
+static void testLazyDocument() {
+    const std::string data = 
+        "{\"skipped\": [[1, 2, {\"a\": [3]}], {\"b\": \"c\"}], \"key\\u0031\": {\"inner\": [true, null, -1.5e3, \"a\\nb\"]}, "
+        "\"number\": 18446744073709551615, \"number\": 1.5, \"empty\": []}";
+
+    LazyDocument document;
+    assert(document.parse(data) == Error::NONE);
+
+    assert(document["key1"]["inner"][0U].asBool().getValue());
+    assert(document["key1"]["inner"][1U].asNull().isSuccess());
+    assert(document["key1"]["inner"][2U].asInt64().getValue() == -1500);
+    assert(document["key1"]["inner"][2U].getType().getValue() == JSON::Type::INT64);
+
+    std::string str;
+    assert(document["key1"]["inner"][3U].asString(str));
+    assert(str == "a\nb");
+    assert(document["skipped"][1U]["b"].asString(str));
+    assert(str == "c");
+
+    //the last duplicate key wins
+    assert(document["number"].asFloat64().getValue() == 1.5);
+
+    assert(!document["missing"].isValid());
+    assert(!document["key1"]["inner"][4U].isValid());
+    assert(!document["empty"][0U].isValid());
+    assert(!document["skipped"]["a"].isValid());
+    assert(!document["key1"].asInt64().isSuccess());
+
+    Parser parser;
+    const ParserResult parserResult = document["skipped"].parse(parser);
+    assert(parserResult.isSuccess());
+    assert(parserResult.getRef()[0U][2U]["a"][0U].asUint64().getValue() == 3U);
+
+    assert(document.parse("[1, 2}") == Error::MISSING_COMMA_OR_RBRACKET);
+    assert(!document.getRoot().isValid());
+
+    //truncated inputs fail like they do with Parser
+    assert(document.parse("[1,2") == Error::ARRAY);
+    assert(!document.getRoot().isValid());
+    assert(document.parse("{\"a\":[1") == Error::ARRAY);
+    assert(document.parse("{\"a\":{\"b\":[1,2,3") == Error::ARRAY);
+    assert(document.parse("{\"a\":1") == Error::OBJECT);
+    assert(parser.parse("{\"a\":1").getError() == Error::OBJECT);
+
+    //mismatched brackets fail with the error Parser reaches first
+    assert(document.parse("[[[}") == Error::ARRAY);
+    assert(document.parse("[{]") == Error::OBJECT);
+    assert(document.parse("[[1]") == Error::MISSING_COMMA_OR_RBRACKET);
+    const char *const mismatched[] = {
+        "{{{{", "[[[}", "[{]", "[[1]", "{\"a\" 1]", "{\"a\":1]", "[1 2}", "[\"x\":1}", "{1:2]", "{\"a\":[}"
+    };
+    for(const char *const input : mismatched) {
+        assert(document.parse(input) == parser.parse(input).getError());
+        assert(!document.getRoot().isValid());
+    }
+}
+
+struct EventCounter {
+    unsigned    objects  = 0U,
+                arrays   = 0U,
+                closed   = 0U,
+                literals = 0U;
+    double      sum      = 0.0;
+    std::string keys,
+                strings;
+
+    void startObject() { objects++; }
+    void endObject()   { closed++; }
+    void startArray()  { arrays++; }
+    void endArray()    { closed++; }
+    void key   (const char *str, unsigned length) { keys.append(str, length); }
+    void string(const char *str, unsigned length) { strings.append(str, length); }
+    void int64  (std::int64_t value)  { sum += double(value); }
+    void uint64 (std::uint64_t value) { sum += double(value); }
+    void float64(double value)        { sum += value; }
+    void boolean(bool)                { literals++; }
+    void null   ()                    { literals++; }
+};
+
+static void testSaxHandler() {
+    Parser parser;
+    EventCounter counter;
+    const std::string data = "{\"a\": [1, -2, 3.5, true, null, \"x\\ny\"], \"b\": {\"c\": {}}, \"d\": []}";
+    assert(parser.parse(data, counter) == Error::NONE);
+
+    assert(counter.objects  == 3U);
+    assert(counter.arrays   == 2U);
+    assert(counter.closed   == 5U);
+    assert(counter.sum      == 2.5);
+    assert(counter.literals == 2U);
+    assert(counter.keys     == "abcd");
+    assert(counter.strings  == "x\ny");
+
+    //same errors as building a JSON
+    EventCounter errors;
+    assert(parser.parse("{\"key1\": \"value1\", \"key2\": }", errors) == Error::OBJECT);
+    assert(parser.parse("[1 2]", errors) == Error::MISSING_COMMA_OR_RBRACKET);
+    assert(parser.parse("[1, 2] x", errors) == Error::TOKEN);
+
+    //an integer variable is a length, not a handler
+    const char *const buffer = "[1, 2]x";
+    int length = 6;
+    assert(parser.parse(buffer, length).isSuccess());
+    unsigned unsignedLength = 6U;
+    assert(parser.parse(buffer, unsignedLength).getRef().toString() == "[1,2]");
+}
+
+static void testReset() {
+    std::string data = "[";
+    for(unsigned i = 0U; i < 1000U; i++) {
+        data += "{\"key\": \"a longer string value\", \"array\": [1, 2.5, null, \"escaped\\n\"]},";
+    }
+    data += "{}]";
+
+    //the arenas are sized for the first document, the next ones need more nodes
+    Parser parser;
+    assert(parser.parse("[1]").isSuccess());
+    const std::string expected = parser.parse(data).getRef().toString();
+    for(unsigned i = 0U; i < 3U; i++) {
+        parser.reset();
+        const ParserResult parserResult = parser.parse(data);
+        assert(parserResult.isSuccess());
+        assert(parserResult.getRef().toString() == expected);
+    }
+    parser.reset();
+
+#ifndef NDEBUG
+    //the arenas and the tokens are reused once they are large enough
+    const unsigned allocated = AllocationStats::get().allocated;
+    for(unsigned i = 0U; i < 100U; i++) {
+        assert(parser.parse(data).isSuccess());
+        parser.reset();
+    }
+    assert(AllocationStats::get().allocated == allocated);
+
+    //small documents parsed without reset share the nodes of the arenas instead of reserving a new one each
+    const unsigned smallAllocated = AllocationStats::get().allocated;
+    for(unsigned i = 0U; i < 1000U; i++) {
+        assert(parser.parse("{\"a\":[1,\"b\"]}").isSuccess());
+    }
+    assert(AllocationStats::get().allocated - smallAllocated < 100U);
+    parser.reset();
+#endif
+}
+
+static void testParseLines() {
+    Parser parser;
+    //documents parsed before are kept
+    const ParserResult earlier = parser.parse("{\"kept\": [1, 2]}");
+    assert(earlier.isSuccess());
+
+    double sum = 0.0;
+    const auto addValue = [&](JSON &json) {
+        sum += json["value"].asFloat64().getValue();
+    };
+
+    //blank lines and \r\n are allowed, the last line doesn't need a newline
+    const std::string lines = "{\"value\": 1.0}\n\n{\"value\": 2.5}\r\n   \n{\"value\": -3.0}";
+    Parser::LinesResult result = parser.parseLines(lines, addValue);
+    assert(result.error   == Error::NONE);
+    assert(result.records == 3U);
+    assert(sum            == 0.5);
+
+    //the failing record and its byte offset are reported
+    sum = 0.0;
+    result = parser.parseLines("{\"value\": 1.0}\n{\"value\": 2.0}\n{\"value\": }\n{\"value\": 4.0}\n", addValue);
+    assert(result.error   == Error::OBJECT);
+    assert(result.records == 2U);
+    assert(result.offset  == 30U);
+    assert(sum            == 3.0);
+
+    //a JSON can't span several lines
+    result = parser.parseLines("[1,\n2]", addValue);
+    assert(result.error   == Error::ARRAY);
+    assert(result.records == 0U);
+    assert(result.offset  == 0U);
+
+    //records larger than the read buffer and records split between two reads
+    const char *const path = "tests/test1-lines.ndjson";
+    std::string big = "{\"value\": 1.0, \"padding\": \"";
+    big.append(3U << 20, 'x');
+    big += "\"}\n";
+    {
+        std::ofstream file(path, std::ios::binary);
+        for(unsigned i = 0U; i < 100000U; i++) {
+            file << "{\"value\": " << i % 10U << ".5, \"padding\": \"abcdefghij\"}\n";
+        }
+        file << big << big << "{\"value\": 2.0}";
+    }
+
+    sum    = 0.0;
+    result = parser.parseLinesFile(path, addValue);
+    assert(result.error   == Error::NONE);
+    assert(result.records == 100003U);
+    assert(sum            == 500004.0);
+
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << big << "{\"value\": 1.0}\n[1, 2";
+    }
+    result = parser.parseLinesFile(path, addValue);
+    assert(result.error   == Error::ARRAY);
+    assert(result.records == 2U);
+    assert(result.offset  == big.size() + 15U);
+    std::remove(path);
+
+    result = parser.parseLinesFile(std::string(path), addValue);
+    assert(result.error == Error::FILE);
+
+    assert(earlier.getRef()["kept"][1U].asUint64().getValue() == 2U);
+}
+
+static void testParseLinesThreads() {
+    //a few chunks, one of the records covers a whole chunk
+    std::string lines;
+    for(unsigned i = 0U; i < 50000U; i++) {
+        lines += "{\"index\": " + std::to_string(i) + ".0, \"padding\": \"abcdefghij\"}\n";
+        if(i == 1000U) {
+            lines += "\n{\"index\": -1.0, \"padding\": \"" + std::string(3U << 19, 'x') + "\"}\r\n\n";
+        }
+    }
+
+    Parser parser;
+    double      expected = 0.0;
+    std::size_t records  = 0U;
+    bool        ordered  = true;
+    const auto checkOrder = [&](JSON &json) {
+        const double index = json["index"].asFloat64().getValue();
+        if(index >= 0.0) {
+            ordered  = ordered && index == expected;
+            expected = index + 1.0;
+        }
+        records++;
+    };
+
+    Parser::LinesResult result = parser.parseLines(lines, checkOrder, 4U);
+    assert(result.error   == Error::NONE);
+    assert(result.records == 50001U);
+    assert(records        == 50001U);
+    assert(expected       == 50000.0);
+    assert(ordered);
+
+    const char *const path = "tests/test1-lines-threads.ndjson";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << lines;
+    }
+    expected = 0.0;
+    records  = 0U;
+    result   = parser.parseLinesFile(path, checkOrder, 0U);
+    assert(result.error   == Error::NONE);
+    assert(result.records == 50001U);
+    assert(records        == 50001U);
+    assert(expected       == 50000.0);
+    assert(ordered);
+
+    //the records before the invalid one are delivered, same error as on a single thread
+    const std::size_t invalid = lines.find("{\"index\": 40000.0");
+    lines[invalid + 1U] = 'x';
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << lines;
+    }
+    const Parser::LinesResult single = parser.parseLines(lines, [](JSON&) {});
+    assert(single.records == 40001U);
+    assert(single.offset  == invalid);
+
+    expected = 0.0;
+    records  = 0U;
+    result   = parser.parseLines(lines, checkOrder, 3U);
+    assert(result.error   == single.error);
+    assert(result.records == single.records);
+    assert(result.offset  == single.offset);
+    assert(records        == single.records);
+    assert(ordered);
+
+    expected = 0.0;
+    records  = 0U;
+    result   = parser.parseLinesFile(path, checkOrder, 2U);
+    assert(result.error   == single.error);
+    assert(result.records == single.records);
+    assert(result.offset  == single.offset);
+    assert(ordered);
+    std::remove(path);
+
+    assert(parser.parseLines("", checkOrder, 4U).records == 0U);
+    assert(parser.parseLinesFile(path, checkOrder, 4U).error == Error::FILE);
+}
+
+static void testParseParallel() {
+    //large enough to be split
+    const std::string padding(128U, 'x');
+    std::string data = "[";
+    for(unsigned i = 0U; i < 7000U; i++) {
+        data += "{\"index\": " + std::to_string(i) + ", \"values\": [1.5, \"escaped\\n\", null, {\"nested\": [[], {}]}], \"padding\": \"" + padding + "\"},";
+    }
+    data += "\"last\", -1, true, [\"[\\\"\", \"]\"]  ]";
+
+    Parser sequential;
+    const std::string expected = sequential.parse(data).getRef().toString();
+
+    Parser parser;
+    for(unsigned threads = 1U; threads <= 4U; threads++) {
+        const ParserResult parserResult = parser.parseParallel(data, threads);
+        assert(parserResult.isSuccess());
+        assert(parserResult.getRef().toString() == expected);
+    }
+    //the elements stay valid until reset, the worker parsers are reused after it
+    const ParserResult first = parser.parseParallel(data, 4U);
+    assert(parser.parseParallel(data, 4U).isSuccess());
+    assert(first.getRef().toString() == expected);
+    parser.reset();
+    assert(parser.parseParallel(data, 0U).getRef().toString() == expected);
+
+    const char *const path = "tests/test1-parallel.json";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << data;
+    }
+    assert(parser.parseFileParallel(path, 3U).getRef().toString() == expected);
+    std::remove(path);
+
+    //invalid documents give the same error as parse
+    const auto sameError = [&](const std::string &invalid) {
+        const ParserResult parserResult = parser.parseParallel(invalid, 4U);
+        assert(!parserResult.isSuccess());
+        assert(parserResult.getError() == sequential.parse(invalid).getError());
+    };
+    const std::size_t middle = data.find("{\"index\": 3500");
+    std::string invalid = data;
+    invalid.replace(middle, 1U, "1 ");
+    sameError(invalid);
+    invalid = data;
+    invalid[data.find(", null", middle) + 3U] = 'x';
+    sameError(invalid);
+    invalid = data;
+    invalid.replace(middle - 1U, 1U, ",,");
+    sameError(invalid);
+    invalid = data;
+    invalid.back() = '}';
+    sameError(invalid);
+    invalid = data;
+    invalid.replace(data.find("[[]", middle), 3U, "[[}");
+    sameError(invalid);
+    sameError(data + " garbage");
+    sameError(data + " }");
+
+    //documents that aren't arrays and trailing content behave as parse
+    const std::string object = "{\"array\": " + data + "}";
+    assert(parser.parseParallel(object, 4U).getRef().toString() == sequential.parse(object).getRef().toString());
+    assert(parser.parseParallel(data + " [1]", 4U).getRef().toString() == expected);
+
+    //the elements are one level deeper than their root
+    Parser::Options options;
+    options.maxDepth = 6U;
+    parser.setOptions(options);
+    sequential.setOptions(options);
+    assert(parser.parseParallel(data, 4U).getRef().toString() == expected);
+    options.maxDepth = 5U;
+    parser.setOptions(options);
+    sequential.setOptions(options);
+    sameError(data);
+}
+
+struct BoundPoint {
+    int    x = 0;
+    double y = 0.0;
+};
+
+struct BoundItem {
+    std::string              name;
+    std::uint64_t            id     = 0U;
+    bool                     active = false;
+    BoundPoint               origin;
+    std::vector<BoundPoint>  points;
+    std::vector<std::string> tags;
+    std::vector<bool>        flags;
+    std::vector<std::vector<unsigned char>> grid;
+};
+
+CPPJSON_BIND(BoundPoint, x, y)
+CPPJSON_BIND(BoundItem, name, id, active, origin, points, tags, flags, grid)
+
+static void testParseInto() {
+    Parser parser;
+
+    const std::string data =
+        "{\"name\": \"first\\n\", \"unknown\": {\"a\": [1, {\"b\": null}]}, \"id\": 18446744073709551615,"
+        " \"active\": true, \"origin\": {\"x\": -3, \"y\": 2, \"z\": \"skipped\"},"
+        " \"points\": [{\"x\": 1, \"y\": 1.5}, {}, {\"y\": 1e2}], \"tags\": [\"a\", \"\\u00e9\"],"
+        " \"flags\": [true, false, true], \"grid\": [[1, 2], [], [255]], \"origin\": {\"x\": 4}}";
+
+    BoundItem item;
+    assert(parser.parseInto(data, item) == Error::NONE);
+    assert(item.name == "first\n");
+    assert(item.id == std::numeric_limits<std::uint64_t>::max());
+    assert(item.active);
+    //the second origin only sets x
+    assert(item.origin.x == 4 && item.origin.y == 2.0);
+    assert(item.points.size() == 3U);
+    assert(item.points[0].x == 1 && item.points[0].y == 1.5);
+    assert(item.points[1].x == 0 && item.points[1].y == 0.0);
+    assert(item.points[2].y == 100.0);
+    assert(item.tags.size() == 2U && item.tags[1] == "\xC3\xA9");
+    assert(item.flags.size() == 3U && item.flags[0] && !item.flags[1] && item.flags[2]);
+    assert(item.grid.size() == 3U && item.grid[0].size() == 2U && item.grid[1].empty() && item.grid[2][0] == 255U);
+
+    std::vector<BoundPoint> points;
+    assert(parser.parseInto("[{\"x\": 1}, null, {\"x\": 3}]", points) == Error::NONE);
+    assert(points.size() == 3U && points[1].x == 0 && points[2].x == 3);
+
+    //null leaves the value unchanged
+    BoundPoint point;
+    point.x = 7;
+    assert(parser.parseInto("{\"x\": null, \"y\": 0.5}", point) == Error::NONE);
+    assert(point.x == 7 && point.y == 0.5);
+
+    //values of the wrong type or out of range
+    assert(parser.parseInto("{\"x\": 1.5}", point)        == Error::TYPE);
+    assert(parser.parseInto("{\"x\": 1e-2}", point)       == Error::TYPE);
+    assert(parser.parseInto("{\"x\": 3000000000}", point) == Error::TYPE);
+    assert(parser.parseInto("{\"x\": \"1\"}", point)      == Error::TYPE);
+    assert(parser.parseInto("[1]", point)                == Error::TYPE);
+    assert(parser.parseInto("{\"id\": -1}", item)         == Error::TYPE);
+    assert(parser.parseInto("{\"grid\": [[256]]}", item)  == Error::TYPE);
+    assert(parser.parseInto("{\"tags\": \"a\"}", item)    == Error::TYPE);
+
+    //the same syntax errors as parse, skipped values included
+    const char *const invalid[] = {
+        "{\"x\": 1 \"y\": 2}",
+        "{\"x\" 1}",
+        "{\"x\": }",
+        "{\"x\": 1,}",
+        "{1: 1}",
+        "{\"x\": 1",
+        "{\"z\": [1 2]}",
+        "{\"z\": [1, }",
+        "{\"z\": tru}",
+        "{\"x\": 1} ]",
+        "{\"y\": 01}"
+    };
+    for(const char *const json : invalid) {
+        const Error error = parser.parseInto(json, point);
+        assert(error != Error::NONE);
+        assert(error == parser.parse(json).getError());
+        parser.reset();
+    }
+
+    Parser::Options options;
+    options.maxDepth = 2U;
+    parser.setOptions(options);
+    assert(parser.parseInto("{\"origin\": {\"x\": 1}}", item)  == Error::NONE);
+    assert(parser.parseInto("{\"grid\": [[1]]}", item)          == Error::DEPTH);
+    assert(parser.parseInto("{\"unknown\": [[1]]}", item)       == Error::DEPTH);
+    assert(parser.parseInto("{\"unknown\": [1]}", item)         == Error::NONE);
+}
+
+static void testObjectTable() {
+    Parser parser;
+    JSON &json = parser.init().getRef();
+    Object &object = json.makeObject(parser.getObjectAllocator()).getRef();
+
+    //grows from the first insertion, without reserving
+    const unsigned count = 1000U;
+    for(unsigned i = 0U; i < count; i++) {
+        assert(object.set(parser.createString(std::to_string(i).c_str()), i));
+    }
+    assert(object.size() == count);
+
+    //removing moves the last member in the hole, lookups still find every other member
+    for(unsigned i = 0U; i < count; i += 3U) {
+        object.remove(std::to_string(i));
+    }
+    object.remove("missing");
+    for(unsigned i = 0U; i < count; i++) {
+        const Result<std::uint64_t> value = object.getUint64(std::to_string(i));
+        assert(value.isSuccess() == (i % 3U != 0U));
+        assert(!value.isSuccess() || value.getValue() == i);
+    }
+
+    unsigned members = 0U;
+    for(const Object::KeyValueType &keyValue : object) {
+        assert(std::to_string(keyValue.second.unsafeAsUint64()) == keyValue.first.getCString());
+        members++;
+    }
+    assert(members == object.size() && members == count - (count + 2U) / 3U);
+
+    //copies are independent of the original
+    const JSON copy = json;
+    object.remove("1");
+    assert(copy.unsafeAsObject().size() == members && copy.unsafeAsObject().has("1"));
+    assert(copy["2"].asUint64().getValue() == 2U);
+
+    //parsed objects are sized from the lexer and keep the document order
+    const ParserResult parserResult = parser.parse("{\"b\": 1, \"a\": {\"d\": 2, \"c\": [3]}, \"b\": 4}");
+    assert(parserResult.isSuccess());
+    assert(parserResult.getRef().toString() == "{\"b\":4,\"a\":{\"d\":2,\"c\":[3]}}");
+}
+
+static void testSmallObjects() {
+    Parser parser;
+    JSON &json = parser.init().getRef();
+    Object &object = json.makeObject(parser.getObjectAllocator()).getRef();
+
+    //every member is found while the keys are scanned, once they get hashed and after removing back below the limit
+    const unsigned count = CPPJSON_SMALL_OBJECT_SIZE + 4U;
+    for(unsigned i = 0U; i < count; i++) {
+        assert(object.set(parser.createString(std::to_string(i).c_str()), i));
+        assert(!object.has(std::to_string(i + 1U)));
+        for(unsigned j = 0U; j <= i; j++) {
+            assert(object.getUint64(std::to_string(j)).getValue() == j);
+        }
+    }
+    for(unsigned i = count; i-- > 0U;) {
+        object.remove(std::to_string(i % 2U == 0U ? i : count - i));
+        assert(object.size() == i);
+    }
+    assert(object.size() == 0U);
+
+    //keys of the same length that only differ at the end, replacing a member keeps its place
+    assert(object.set(parser.createString("key1"), 1U));
+    assert(object.set(parser.createString("key2"), 2U));
+    assert(object.set(parser.createString("key1"), 3U));
+    assert(object.size() == 2U && !object.has("key") && !object.has("key12"));
+    assert(json.toString() == "{\"key1\":3,\"key2\":2}");
+
+    const JSON copy = json;
+    object.remove("key1");
+    assert(copy.toString() == "{\"key1\":3,\"key2\":2}");
+    assert(json.toString() == "{\"key2\":2}");
+    assert(copy["key1"].asUint64().getValue() == 3U);
+
+    //parsed keys are borrowed from the input
+    const ParserResult parserResult = parser.parse("{\"ab\": 1, \"a\": 2, \"\": 3, \"b\\u0041\": 4}");
+    assert(parserResult.isSuccess());
+    const JSON &parsed = parserResult.getRef();
+    assert(parsed["ab"].asUint64().getValue() == 1U);
+    assert(parsed["a"].asUint64().getValue() == 2U);
+    assert(parsed[""].asUint64().getValue() == 3U);
+    assert(parsed["bA"].asUint64().getValue() == 4U);
+    assert(!parsed.unsafeAsObject().has("b"));
+}
+
+static void testKeyHash() {
+    //every length up to past the 48 bytes blocks, at every alignment, prefixes don't collide
+    const std::string text = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789abcdefghijklmnopqrstuvwxyz0123456789";
+    std::vector<std::uint64_t> hashes;
+    for(std::size_t length = 0U; length <= text.size(); length++) {
+        const std::uint64_t hash = Hash::hash(text.data(), length);
+        for(std::size_t offset = 1U; offset < 8U; offset++) {
+            const std::string shifted = std::string(offset, ' ') + text.substr(0U, length);
+            assert(Hash::hash(shifted.data() + offset, length) == hash);
+        }
+        for(const std::uint64_t previous : hashes) {
+            assert(previous != hash);
+        }
+        hashes.push_back(hash);
+    }
+
+    //the same key has the same hash whatever it is stored in
+    Parser parser;
+    JSON &json = parser.init().getRef();
+    const String key = parser.createString("user_id");
+    const std::string stdKey = "user_id";
+    assert(StringHasher()(key) == StringHasher()(stdKey));
+    assert(StringHasher()(key) == StringHasher()(KeyView("user_id")));
+    assert(StringEqual()(key, KeyView(stdKey)) && !StringEqual()(key, KeyView("user_i")));
+    assert(StringEqual()("a", "a") && !StringEqual()("a", "ab"));
+
+    //long keys in an object large enough to be hashed
+    Object &object = json.makeObject(parser.getObjectAllocator()).getRef();
+    const unsigned count = CPPJSON_SMALL_OBJECT_SIZE * 2U;
+    for(unsigned i = 0U; i < count; i++) {
+        assert(object.set(parser.createString((text + std::to_string(i)).c_str()), i));
+    }
+    for(unsigned i = 0U; i < count; i++) {
+        assert(object.getUint64(text + std::to_string(i)).getValue() == i);
+    }
+    assert(!object.has(text) && !object.has(text.substr(1U) + "0"));
+}
+
+static void testObjectKey() {
+    //records small enough to be scanned and one large enough to be hashed
+    std::string data = "[{\"id\": 1, \"user_id\": -7}, {\"user_id\": 8, \"name\": \"b\"}, {\"id\": 3}, {";
+    const unsigned count = CPPJSON_SMALL_OBJECT_SIZE * 2U;
+    for(unsigned i = 0U; i < count; i++) {
+        data += "\"key" + std::to_string(i) + "\": " + std::to_string(i) + ", ";
+    }
+    data += "\"user_id\": 9}]";
+
+    Parser parser;
+    const ParserResult parserResult = parser.parse(data);
+    assert(parserResult.isSuccess());
+    const JSON &json = parserResult.getRef();
+
+    const Object::Key userId("user_id");
+    const std::string name = "name";
+    const Object::Key nameKey(name);
+    assert(userId.length == 7U && userId.hash == StringHasher()(parser.createString("user_id")));
+
+    const std::int64_t expected[] = {-7, 8, 0, 9};
+    unsigned index = 0U;
+    for(const JSON &record : json.unsafeAsArray()) {
+        const Object &object = record.unsafeAsObject();
+        assert(object.has(userId) == (index != 2U));
+        assert(object.getInt64(userId).isSuccess() == (index != 2U));
+        assert(index == 2U || object.getInt64(userId).getValue() == expected[index]);
+        assert(object.get(nameKey).isSuccess() == (index == 1U));
+        index++;
+    }
+    assert(json[1U][nameKey].asString().getRef() == "b");
+    assert(json[3U][userId].asInt64().getValue() == 9);
+    assert(json[3U][Object::Key("key5")].asUint64().getValue() == 5U);
+    assert(!json[2U][userId].get().isSuccess());
+    assert(!json[Object::Key("user_id")].get().isSuccess());
+}
+
+static void testConcurrentLookups() {
+    //a small object and one large enough to be hashed, the keys are borrowed from the input
+    std::string data = "{\"small\": {\"a\": 1, \"b\": 2}, \"large\": {";
+    const unsigned count = CPPJSON_SMALL_OBJECT_SIZE * 4U;
+    for(unsigned i = 0U; i < count; i++) {
+        data += (i == 0U ? "\"" : ", \"") + std::to_string(i) + "\": " + std::to_string(i);
+    }
+    data += "}}";
+
+    Parser parser;
+    const ParserResult parserResult = parser.parse(data);
+    assert(parserResult.isSuccess());
+    const JSON &json = parserResult.getRef();
+
+    //const char* and std::string keys don't use any shared memory so readers don't need a lock
+    std::vector<std::thread> threads;
+    for(unsigned t = 0U; t < 4U; t++) {
+        threads.emplace_back([&json, count]() {
+            for(unsigned round = 0U; round < 100U; round++) {
+                const Object &large = json["large"].unsafeAsObject();
+                for(unsigned i = 0U; i < count; i++) {
+                    const std::string key = std::to_string(i);
+                    assert(large.getUint64(key).getValue() == i);
+                    assert(json["large"][key.c_str()].asUint64().getValue() == i);
+                }
+                assert(!large.has("missing") && !large.has(std::to_string(count)));
+                assert(json["small"]["b"].asUint64().getValue() == 2U);
+                assert(!json["small"]["c"].get().isSuccess());
+            }
+        });
+    }
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+static void testLargeOffsets() {
+    if(sizeof(std::size_t) < 8U) {
+        return;
+    }
+
+    //a 4 GB input doesn't fit in a test, the token array is filled the way the lexer does it
+    const std::size_t GB4       = std::size_t(1U) << 32;
+    const std::size_t offsets[] = {0U, 10U, GB4 + 20U, GB4 + 30U, 3U * GB4 + 5U, 3U * GB4 + 6U};
+
+    Tokens tokens;
+    for(const std::size_t offset : offsets) {
+        Token *const token = tokens.nextToken();
+        assert(token != nullptr);
+        token->offset = std::uint32_t(offset);
+        token->set(Token::Type::INT, 1U);
+        assert(tokens.addSegments(offset));
+    }
+    //a token longer than 4 GB skips a segment
+    assert(tokens.segments.size() == 3U);
+
+    for(std::size_t i = 0U; i < tokens.data.size(); i++) {
+        assert(tokens.offset(tokens.data[i]) == offsets[i]);
+    }
+
+    tokens.reset();
+    assert(tokens.segments.empty());
+
+    //lengths are size_t, small inputs parse the same
+    Parser parser;
+    const std::string data = "[1, \"a\", {\"b\": null}]";
+    assert(parser.parse(data.c_str(), data.size()).isSuccess());
+}
+
+static void testSerialize() {
+    BoundItem item;
+    item.name   = "a \"quoted\"\n\x01name\\";
+    item.id     = std::numeric_limits<std::uint64_t>::max();
+    item.active = true;
+    item.origin.x = -3;
+    item.origin.y = 0.5;
+    item.points.resize(2U);
+    item.points[1].x = std::numeric_limits<int>::min();
+    item.points[1].y = -0.125;
+    item.tags.push_back("\xC3\xA9");
+    item.flags.push_back(true);
+    item.flags.push_back(false);
+    item.grid.resize(2U);
+    item.grid[1].push_back(255U);
+
+    Writer writer;
+    assert(serialize(item, writer) == Error::NONE);
+    assert(writer.toString() ==
+        "{\"name\":\"a \\\"quoted\\\"\\n\\u0001name\\\\\",\"id\":18446744073709551615,\"active\":true,"
+        "\"origin\":{\"x\":-3,\"y\":0.5},\"points\":[{\"x\":0,\"y\":0},{\"x\":-2147483648,\"y\":-0.125}],"
+        "\"tags\":[\"\xC3\xA9\"],\"flags\":[true,false],\"grid\":[[],[255]]}");
+
+    //the output reads back into the same values
+    Parser parser;
+    BoundItem copy;
+    assert(parser.parseInto(writer.getData(), writer.getSize(), copy) == Error::NONE);
+    assert(copy.name == item.name && copy.id == item.id && copy.origin.x == -3 && copy.points[1].y == -0.125);
+    assert(copy.points[1].x == item.points[1].x && copy.flags == item.flags && copy.grid == item.grid);
+
+    //the buffer is reused after clear
+    writer.clear();
+    std::vector<float> floats;
+    floats.push_back(0.1f);
+    floats.push_back(std::numeric_limits<float>::infinity());
+    assert(serialize(floats, writer) == Error::NONE);
+    assert(writer.toString() == "[0.100000001,null]");
+
+    //escapes past the first vector of the scan
+    writer.clear();
+    std::string longString(100U, 'a');
+    longString[40U] = '\x1F';
+    longString[70U] = '"';
+    assert(serialize(longString, writer) == Error::NONE);
+    assert(writer.toString() == "\"" + std::string(40U, 'a') + "\\u001f" + std::string(29U, 'a') + "\\\"" + std::string(29U, 'a') + "\"");
+
+    //a writer is also a handler of the events of parse
+    writer.clear();
+    const std::string data = "{ \"a\\u0001\": [1, -2, 1.5, \"x\\ty\", true, false, null, {}, []] }";
+    assert(parser.parse(data, writer) == Error::NONE);
+    assert(writer.toString() == "{\"a\\u0001\":[1,-2,1.5,\"x\\ty\",true,false,null,{},[]]}");
+}
+
 int main() {
     testEmptyObject();
     testEmptyArray();
@@ -616,6 +1620,28 @@ int main() {
     testCreatePrimitives();
     testCreateArray();
     testCreateObject();
+    testMaxDepth();
+    testLongEscapedStrings();
+    testVeryDeepNesting();
+    testBorrowedStrings();
+    testParseInPlace();
+    testFused();
+    testNumbers();
+    testScientificIntegers();
+    testLazyDocument();
+    testSaxHandler();
+    testReset();
+    testParseLines();
+    testParseLinesThreads();
+    testParseParallel();
+    testLargeOffsets();
+    testSerialize();
+    testObjectTable();
+    testSmallObjects();
+    testKeyHash();
+    testObjectKey();
+    testConcurrentLookups();
+    testParseInto();
 
     std::cout << "All tests successful\n";
 
@@ -1,11 +1,16 @@
 #pragma once
 
 #include <stdio.h>
+#include <cstddef>
+#include <cstdint>
 
 namespace CPPJSON {
 
 struct Tokens;
 
+//8 bytes: the low 32 bits of the offset of the token in the input, its length in the low 28 bits and its type in
+//the high 4 bits. Lengths saturate at MAX_LENGTH, containers store their comma count in the length.
+//The high bits of the offset are kept by Tokens and LexerStream, only inputs past 4 GB have any.
 struct Token {
     enum class Type {
         LCURLY,
@@ -24,9 +29,34 @@ struct Token {
         DONE
     };
 
-    const char *value;
-    unsigned    length;
-    Type        type;
+    static const unsigned      LENGTH_BITS = 28U;
+    static const std::uint32_t MAX_LENGTH  = (std::uint32_t(1U) << LENGTH_BITS) - 1U;
+
+    std::uint32_t offset;
+    std::uint32_t lengthAndType;
+
+    Type getType() const noexcept {
+        return Type(lengthAndType >> LENGTH_BITS);
+    }
+
+    unsigned getLength() const noexcept {
+        return unsigned(lengthAndType & MAX_LENGTH);
+    }
+
+    void set(const Type type, const std::size_t length) noexcept {
+        const std::uint32_t clamped = length > MAX_LENGTH ? MAX_LENGTH : std::uint32_t(length);
+        lengthAndType = (std::uint32_t(type) << LENGTH_BITS) | clamped;
+    }
+
+    void setType(const Type type) noexcept {
+        set(type, getLength());
+    }
+
+    void setLength(const std::size_t length) noexcept {
+        set(getType(), length);
+    }
 };
 
+static_assert(sizeof(Token) == 8U, "Token should be 8 bytes");
+
 }
\ No newline at end of file
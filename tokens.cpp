@@ -1,18 +1,27 @@
+#include <algorithm>
 #include <cassert>
 
 #include "tokens.hpp"
 
 namespace CPPJSON {
 
-const unsigned Tokens::MINIMUM_CAPACITY = 8U;
+const unsigned    Tokens::MINIMUM_CAPACITY = 8U;
+const std::size_t Tokens::MAXIMUM_RESERVE  = std::size_t(1U) << 27;
 
-bool Tokens::reserve(unsigned capacity) noexcept {
+//defined here, -Winline warns when the parsers constructing it don't inline it
+Tokens::Tokens() noexcept = default;
+
+bool Tokens::reserve(std::size_t capacity) noexcept {
     if(capacity < MINIMUM_CAPACITY) {
         capacity = MINIMUM_CAPACITY;
     }
+    //the capacity is an upper bound, past 1 GB the vector grows as the tokens are read instead
+    if(capacity > MAXIMUM_RESERVE) {
+        capacity = MAXIMUM_RESERVE;
+    }
 
     try {
-        data.reserve(std::size_t(capacity));
+        data.reserve(capacity);
         return true;
     } catch(...) {
         return false;
@@ -21,6 +30,7 @@ bool Tokens::reserve(unsigned capacity) noexcept {
 
 void Tokens::reset() noexcept {
     data.clear();
+    segments.clear();
     currentToken = data.data();
 }
 
@@ -33,4 +43,25 @@ CPPJSON::Token *Tokens::nextToken() noexcept {
     }
 }
 
+bool Tokens::addSegments(const std::size_t offset) noexcept {
+    assert(!data.empty());
+
+    //a string longer than 4 GB starts several segments at once
+    try {
+        while((std::uint64_t(offset) >> 32U) > std::uint64_t(segments.size())) {
+            segments.push_back(data.size() - 1U);
+        }
+        return true;
+    } catch(...) {
+        return false;
+    }
+}
+
+std::size_t Tokens::offset(const Token &token) const noexcept {
+    const std::size_t index   = std::size_t(&token - data.data());
+    const std::size_t segment = std::size_t(std::upper_bound(segments.begin(), segments.end(), index) - segments.begin());
+
+    return std::size_t((std::uint64_t(segment) << 32U) | std::uint64_t(token.offset));
+}
+
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -12,23 +14,51 @@ class Parser;
 class Lexer;
 
 struct Tokens {
-    static const unsigned MINIMUM_CAPACITY;
+    static const unsigned    MINIMUM_CAPACITY;
+    static const std::size_t MAXIMUM_RESERVE;
 
-    typedef GeneralAllocator<Token>       Allocator;
-    typedef std::vector<Token, Allocator> Container;
+    typedef GeneralAllocator<Token>                    Allocator;
+    typedef std::vector<Token, Allocator>              Container;
+    typedef GeneralAllocator<std::size_t>              SegmentAllocator;
+    typedef std::vector<std::size_t, SegmentAllocator> Segments;
 
-    Container data{0, Allocator()};
-    Token    *currentToken = nullptr;  
+    Container   data{0, Allocator()};
+    //segments[i] is the index of the first token at or past (i + 1) * 4 GB, empty for smaller inputs
+    Segments    segments{0, SegmentAllocator()};
+    Token      *currentToken = nullptr;  
+    const char *base         = nullptr;
 
-    Tokens()                         noexcept = default;
+    Tokens()                         noexcept;
     Tokens(const Tokens&)                     = delete;
     Tokens(Tokens&&)                 noexcept = default;
     Tokens& operator=(const Tokens&)          = delete;
     Tokens& operator=(Tokens&&)      noexcept = default;
 
-    bool   reserve  (unsigned capacity = 0U) noexcept;
-    void   reset    ()                       noexcept;
-    Token *nextToken()                       noexcept;
+    bool        reserve    (std::size_t capacity = 0U)   noexcept;
+    void        reset      ()                            noexcept;
+    Token      *nextToken  ()                            noexcept;
+    //called with the full offset of the last token when it is past the last segment
+    bool        addSegments(std::size_t offset)          noexcept;
+    std::size_t offset     (const Token &token)    const noexcept;
+
+    //same interface as LexerStream so the parser can read from either
+    Token &current() noexcept {
+        return *currentToken;
+    }
+
+    const char *value(const Token &token) const noexcept {
+        return segments.empty() ? base + token.offset : base + offset(token);
+    }
+
+    void advance() noexcept {
+        currentToken++;
+    }
+
+    //true if there are at least `count` tokens left before DONE, including the current one
+    bool hasTokens(const unsigned count) const noexcept {
+        const Token *const lastToken = data.data() + data.size() - 1;
+        return lastToken - currentToken >= std::ptrdiff_t(count);
+    }
 };
 
 }
\ No newline at end of file
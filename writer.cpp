@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#include "writer.hpp"
+#include "simd.hpp"
+#include "util.hpp"
+
+namespace CPPJSON {
+
+static const std::size_t MINIMUM_CAPACITY = 256U;
+
+bool Writer::reserve(const std::size_t length) noexcept {
+    if(m_error != Error::NONE) {
+        return false;
+    }
+
+    if(m_buffer.size() - m_size >= length) {
+        return true;
+    }
+
+    try {
+        m_buffer.resize(std::max(std::max(m_buffer.size() * 2U, m_size + length), MINIMUM_CAPACITY));
+    } catch(...) {
+        m_error = Error::MEMORY;
+        return false;
+    }
+
+    return true;
+}
+
+void Writer::append(const char *const data, const std::size_t length) noexcept {
+    if(length == 0U || !reserve(length)) {
+        return;
+    }
+
+    std::memcpy(m_buffer.data() + m_size, data, length);
+    m_size += length;
+}
+
+void Writer::separate() noexcept {
+    if(m_comma) {
+        append(",", static_strlen(","));
+    }
+    m_comma = true;
+}
+
+//copies the runs without escapes at once
+void Writer::escape(const char *data, std::size_t length) noexcept {
+    static const char HEX[] = "0123456789abcdef";
+
+    while(length > 0U) {
+        const std::size_t run = Simd::findEscapedChar(data, length);
+        append(data, run);
+        if(run == length) {
+            return;
+        }
+
+        const unsigned char c = static_cast<unsigned char>(data[run]);
+        char        sequence[6] = {'\\', char(c), '0', '0', '0', '0'};
+        std::size_t sequenceLength = 2U;
+        switch(c) {
+        case '"':
+        case '\\':
+            break;
+        case '\b':
+            sequence[1] = 'b';
+            break;
+        case '\f':
+            sequence[1] = 'f';
+            break;
+        case '\n':
+            sequence[1] = 'n';
+            break;
+        case '\r':
+            sequence[1] = 'r';
+            break;
+        case '\t':
+            sequence[1] = 't';
+            break;
+        default:
+            sequence[1]    = 'u';
+            sequence[4]    = HEX[c >> 4U];
+            sequence[5]    = HEX[c & 0x0FU];
+            sequenceLength = 6U;
+        }
+        append(sequence, sequenceLength);
+
+        data   += run + 1U;
+        length -= run + 1U;
+    }
+}
+
+void Writer::startObject() noexcept {
+    separate();
+    append("{", static_strlen("{"));
+    m_comma = false;
+}
+
+void Writer::endObject() noexcept {
+    append("}", static_strlen("}"));
+    m_comma = true;
+}
+
+void Writer::startArray() noexcept {
+    separate();
+    append("[", static_strlen("["));
+    m_comma = false;
+}
+
+void Writer::endArray() noexcept {
+    append("]", static_strlen("]"));
+    m_comma = true;
+}
+
+void Writer::key(const char *const key, const std::size_t length) noexcept {
+    assert(key != nullptr || length == 0U);
+
+    separate();
+    reserve(length + static_strlen("\"\":"));
+    append("\"", static_strlen("\""));
+    escape(key, length);
+    append("\":", static_strlen("\":"));
+    m_comma = false;
+}
+
+void Writer::rawKey(const char *const key, const std::size_t length) noexcept {
+    assert(key != nullptr);
+
+    separate();
+    append(key, length);
+    m_comma = false;
+}
+
+void Writer::string(const char *const string, const std::size_t length) noexcept {
+    assert(string != nullptr || length == 0U);
+
+    separate();
+    reserve(length + static_strlen("\"\""));
+    append("\"", static_strlen("\""));
+    escape(string, length);
+    append("\"", static_strlen("\""));
+}
+
+void Writer::int64(const std::int64_t value) noexcept {
+    if(value >= 0) {
+        uint64(std::uint64_t(value));
+        return;
+    }
+
+    //the digits of the magnitude then the sign, 0 - value doesn't overflow in unsigned arithmetic
+    char          digits[std::numeric_limits<std::uint64_t>::digits10 + 2];
+    char         *start     = digits + sizeof(digits);
+    std::uint64_t magnitude = std::uint64_t(0U) - std::uint64_t(value);
+    do {
+        *--start   = char('0' + magnitude % 10U);
+        magnitude /= 10U;
+    } while(magnitude != 0U);
+    *--start = '-';
+
+    separate();
+    append(start, std::size_t(digits + sizeof(digits) - start));
+}
+
+void Writer::uint64(std::uint64_t value) noexcept {
+    char  digits[std::numeric_limits<std::uint64_t>::digits10 + 1];
+    char *start = digits + sizeof(digits);
+    do {
+        *--start = char('0' + value % 10U);
+        value   /= 10U;
+    } while(value != 0U);
+
+    separate();
+    append(start, std::size_t(digits + sizeof(digits) - start));
+}
+
+//same format as JSON::toString
+void Writer::float64(const double value) noexcept {
+    if(!std::isfinite(value)) {
+        null();
+        return;
+    }
+
+    char      digits[32];
+    const int count = std::snprintf(digits, sizeof(digits), "%.*g", std::numeric_limits<double>::max_digits10, value);
+    assert(count > 0 && std::size_t(count) < sizeof(digits));
+
+    separate();
+    append(digits, std::size_t(count));
+}
+
+//enough digits to read the same float back, more would show the error of the conversion to double
+void Writer::float32(const float value) noexcept {
+    if(!std::isfinite(value)) {
+        null();
+        return;
+    }
+
+    char      digits[32];
+    const int count = std::snprintf(digits, sizeof(digits), "%.*g", std::numeric_limits<float>::max_digits10, double(value));
+    assert(count > 0 && std::size_t(count) < sizeof(digits));
+
+    separate();
+    append(digits, std::size_t(count));
+}
+
+void Writer::boolean(const bool value) noexcept {
+    separate();
+    if(value) {
+        append("true", static_strlen("true"));
+    } else {
+        append("false", static_strlen("false"));
+    }
+}
+
+void Writer::null() noexcept {
+    separate();
+    append("null", static_strlen("null"));
+}
+
+void Writer::clear() noexcept {
+    m_size  = 0U;
+    m_comma = false;
+    m_error = Error::NONE;
+}
+
+const char *Writer::getData() const noexcept {
+    return m_buffer.data();
+}
+
+std::size_t Writer::getSize() const noexcept {
+    return m_size;
+}
+
+Error Writer::getError() const noexcept {
+    return m_error;
+}
+
+std::string Writer::toString() const {
+    return m_size == 0U
+        ? std::string()
+        : std::string(m_buffer.data(), m_size);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "allocator.hpp"
+#include "error.hpp"
+
+namespace CPPJSON {
+
+//Writes compact JSON text into a buffer that is kept between documents, clear() empties it without freeing it.
+//The functions have the same names as the events of Parser::parse(data, length, handler) so a Writer can also be
+//used as a handler. Commas are added between values, keys and values have to be written in a valid order.
+//A failed allocation is kept in getError() and the writes after it are ignored.
+class Writer {
+    std::vector<char, GeneralAllocator<char>> m_buffer{0, GeneralAllocator<char>()};
+    std::size_t m_size  = 0U;
+    bool        m_comma = false;
+    Error       m_error = Error::NONE;
+
+    bool reserve  (std::size_t length)                   noexcept;
+    void append   (const char*, std::size_t length)      noexcept;
+    void separate ()                                     noexcept;
+    void escape   (const char*, std::size_t length)      noexcept;
+
+public:
+    Writer()                         noexcept = default;
+    Writer(const Writer&)                     = delete;
+    Writer(Writer&&)                 noexcept = default;
+    Writer &operator=(const Writer&)          = delete;
+    Writer &operator=(Writer&&)      noexcept = default;
+
+    void startObject()                                   noexcept;
+    void endObject  ()                                   noexcept;
+    void startArray ()                                   noexcept;
+    void endArray   ()                                   noexcept;
+    void key        (const char*, std::size_t length)    noexcept;
+    void string     (const char*, std::size_t length)    noexcept;
+    void int64      (std::int64_t)                       noexcept;
+    void uint64     (std::uint64_t)                      noexcept;
+    //nan and infinities are written as null
+    void float64    (double)                             noexcept;
+    void float32    (float)                              noexcept;
+    void boolean    (bool)                               noexcept;
+    void null       ()                                   noexcept;
+    //key is already quoted and followed by a colon, used by CPPJSON_BIND
+    void rawKey     (const char *key, std::size_t length) noexcept;
+
+    //keeps the memory of the buffer
+    void        clear    ()       noexcept;
+    const char *getData  () const noexcept;
+    std::size_t getSize  () const noexcept;
+    Error       getError () const noexcept;
+    std::string toString () const;
+};
+
+}
\ No newline at end of file